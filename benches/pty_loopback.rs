@@ -0,0 +1,159 @@
+//! An end-to-end pty loopback benchmark that drives the full server runloop
+//!
+//! A `posix_openpt` pseudo-terminal pair acts as a fake serial device: the benchmark writes timestamped fixed-size
+//! packets into the master side, the server bridges the slave side to UDP, and the benchmark receives the packets on a
+//! local socket to measure throughput, latency percentiles and syscalls per byte. The packet sizes and the amount of
+//! packets per run can be overridden via `BENCH_SIZES` (comma-separated) and `BENCH_COUNT`.
+
+use serial_server::{
+    config::{Capture, Config, Engine, FlowControl, Log, Pool, Sched, Serial, Stats, Transport, Udp},
+    eio,
+    error::Error,
+    framing::Framing,
+    queue::Policy,
+    serial::SerialDevice,
+    server::Server,
+};
+use std::{
+    env,
+    io::Write,
+    net::UdpSocket,
+    process, thread,
+    time::{Duration, Instant},
+};
+
+/// The default packet sizes in bytes
+const SIZES: &[usize] = &[64, 512, 4000];
+/// The default amount of packets per run
+const COUNT: usize = 2000;
+
+pub fn main() {
+    /// The real main function
+    fn _main() -> Result<(), Error> {
+        // Parse the overrides
+        let sizes = match env::var("BENCH_SIZES") {
+            Ok(sizes) => (sizes.split(','))
+                .map(|size| size.trim().parse())
+                .collect::<Result<Vec<usize>, _>>()
+                .map_err(|_| eio!("Invalid BENCH_SIZES"))?,
+            Err(_) => SIZES.to_vec(),
+        };
+        let count = match env::var("BENCH_COUNT") {
+            Ok(count) => count.trim().parse().map_err(|_| eio!("Invalid BENCH_COUNT"))?,
+            Err(_) => COUNT,
+        };
+
+        // Run the benchmark for each packet size
+        for size in sizes {
+            run(size, count)?;
+        }
+        Ok(())
+    }
+
+    // Call the real main function
+    if let Err(e) = _main() {
+        eprintln!("{e}");
+        process::exit(1);
+    }
+}
+
+/// Pumps `count` packets of `size` bytes through a pty-backed server instance and reports the results
+fn run(size: usize, count: usize) -> Result<(), Error> {
+    // Create the pty pair and the receiving socket
+    let (mut master, slave_path) = SerialDevice::openpt()?;
+    let receiver = UdpSocket::bind("127.0.0.1:0")?;
+    receiver.set_read_timeout(Some(Duration::from_secs(5)))?;
+    let send_address = receiver.local_addr()?.to_string();
+
+    // Bridge the slave side to UDP with fixed-size framing
+    let config = Config {
+        engine: Engine::Threads,
+        serial: Some(Serial {
+            device: slave_path,
+            baudrate: 115200,
+            flow_control: FlowControl::None,
+            drain: false,
+            vmin: 1,
+            vtime: 0,
+            adaptive: false,
+            low_latency: false,
+            framing: Framing::Fixed { length: size },
+        }),
+        udp: Some(Udp {
+            transport: Transport::Udp,
+            listen: "127.0.0.1:0".to_string(),
+            send: vec![send_address],
+            ttl: 64,
+            mtu: size.max(1472),
+            rcvbuf: 0,
+            sndbuf: 0,
+            coalesce_us: 0,
+            compress_min: 0,
+            busy_poll_us: 0,
+            batch: 1,
+            queue: 64,
+            write_queue: 64,
+            write_policy: Policy::Block,
+            client_queue: 64,
+            nodelay: true,
+            subscribers: 0,
+            subscriber_ttl_secs: 30,
+        }),
+        bridge: Vec::new(),
+        pool: Pool { count: 32, size: 4096 },
+        sched: Sched::default(),
+        capture: Capture::default(),
+        log: Log { enabled: false },
+        stats: Stats { interval_secs: 0 },
+    };
+    let server = Server::new(config)?;
+    let stats = server.stats();
+    thread::spawn(move || server.runloop());
+
+    // Pump the timestamped packets through the master side
+    let epoch = Instant::now();
+    let writer = thread::spawn(move || -> Result<(), Error> {
+        let mut packet = vec![0xaa; size];
+        for _ in 0..count {
+            // Stamp the packet with the send time
+            let nanos = epoch.elapsed().as_nanos() as u64;
+            packet[..8].copy_from_slice(&nanos.to_be_bytes());
+            master.write_all(&packet)?;
+        }
+        Ok(())
+    });
+
+    // Receive the packets and collect the per-frame latencies
+    let mut latencies = Vec::with_capacity(count);
+    let mut buf = vec![0; 65536];
+    let mut received_bytes = 0;
+    let mut frames = 0;
+    let started = Instant::now();
+    while frames < count {
+        // Stop if the pipeline stalls for longer than the read timeout
+        let Ok(bytes) = receiver.recv(&mut buf) else { break };
+        received_bytes += bytes;
+
+        // A datagram may coalesce multiple fixed-size frames
+        for frame in buf[..bytes].chunks_exact(size) {
+            let sent_nanos = u64::from_be_bytes(frame[..8].try_into().expect("Frame is too short"));
+            latencies.push((epoch.elapsed().as_nanos() as u64).saturating_sub(sent_nanos));
+            frames += 1;
+        }
+    }
+    let elapsed = started.elapsed();
+    writer.join().expect("Writer thread has panicked")?;
+
+    // Summarize the run
+    latencies.sort_unstable();
+    let p50 = latencies.get(latencies.len() / 2).copied().unwrap_or(0) as f64 / 1000.0;
+    let p99 = latencies.get(latencies.len() * 99 / 100).copied().unwrap_or(0) as f64 / 1000.0;
+    let throughput = received_bytes as f64 / elapsed.as_secs_f64() / (1024.0 * 1024.0);
+    let (reads, sends) = (stats.serial_chunks(), stats.udp_tx_packets());
+    let syscalls_per_byte = (reads + sends) as f64 / received_bytes.max(1) as f64;
+    println!(
+        "{size:>5} B packets: {frames:>6}/{count} frames, {throughput:>7.2} MiB/s, p50 {p50:>8.1}us, \
+         p99 {p99:>8.1}us, {syscalls_per_byte:.5} syscalls/B ({reads} reads, {sends} sends)"
+    );
+    Ok(())
+}
@@ -1,15 +1,15 @@
 use cc::Build;
 use std::env::consts::FAMILY;
 
-/// Select the platform specific source file
-fn select_impl() -> &'static str {
+/// Select the platform specific source files
+fn select_impl() -> &'static [&'static str] {
     match FAMILY {
-        "unix" => "src/serial/unix.c",
+        "unix" => &["src/serial/unix.c", "src/net/unix.c", "src/uring/unix.c"],
         family => panic!("Unsupported target OS family: {family}"),
     }
 }
 
 fn main() {
-    // Build and link the helper shim
-    Build::new().file(select_impl()).warnings_into_errors(true).compile("serial");
+    // Build and link the helper shims
+    Build::new().files(select_impl()).warnings_into_errors(true).compile("shims");
 }
@@ -0,0 +1,207 @@
+//! Implements a memory-mapped ring-file flight recorder for postmortem capture of the raw serial traffic
+//!
+//! The recorder appends timestamped raw frames into a fixed-size, memory-mapped ring file with a single memcpy and no
+//! syscalls on the hot path – the kernel flushes the dirty pages in the background, and the file survives a crash of
+//! the process. The newest window can be extracted after an incident via the `dump` subcommand.
+
+use crate::error::Error;
+use std::{
+    fs, io,
+    io::Write,
+    os::fd::AsRawFd,
+    ptr, slice,
+    sync::atomic::{AtomicU64, Ordering},
+    time::SystemTime,
+};
+
+extern "C" {
+    // void* capture_map(int64_t fd, uint64_t len)
+    fn capture_map(fd: i64, len: u64) -> *mut u8;
+
+    // void capture_unmap(void* map, uint64_t len)
+    fn capture_unmap(map: *mut u8, len: u64);
+}
+
+/// The magic prefix of a capture ring file
+const FILE_MAGIC: [u8; 8] = *b"SSCAPT01";
+/// The size of the file header (magic, ring capacity and the atomic logical write offset)
+const HEADER: u64 = 64;
+/// The magic prefix of a record, used to resynchronize on partially overwritten records
+const RECORD_MAGIC: [u8; 4] = *b"SSRC";
+/// The size of a record header (magic, timestamp, direction and payload length)
+const RECORD_HEADER: u64 = 17;
+
+/// The direction of a captured frame
+#[derive(Debug, Clone, Copy)]
+pub enum Direction {
+    /// A frame read from the serial device
+    Serial2Udp = 0,
+    /// A datagram written to the serial device
+    Udp2Serial = 1,
+}
+
+/// A flight recorder over a memory-mapped ring file
+///
+/// Writers reserve their record's range via an atomic offset in the mapped header, so all runloop threads can record
+/// concurrently without locking; the ring simply overwrites the oldest records once it is full
+pub struct Recorder {
+    /// The base address of the memory-mapped ring file
+    map: *mut u8,
+    /// The total length of the mapping in bytes
+    len: u64,
+    /// The capacity of the ring data area in bytes
+    capacity: u64,
+}
+// The recorder is shared across the runloop threads; all mutation goes through the atomic write offset and the
+// disjoint reserved record ranges
+unsafe impl Send for Recorder {}
+unsafe impl Sync for Recorder {}
+impl Recorder {
+    /// Creates a new flight recorder over the ring file at `path` with `size` bytes of ring capacity
+    pub fn new(path: &str, size: usize) -> Result<Self, Error> {
+        // Open the backing file at its fixed size
+        if size < 4096 {
+            return Err(eio!("The capture ring size must be at least 4096 bytes"));
+        }
+        let (capacity, len) = (size as u64, HEADER + size as u64);
+        let file = fs::OpenOptions::new().read(true).write(true).create(true).open(path)?;
+        let existing = file.metadata()?.len() == len;
+        file.set_len(len)?;
+
+        // Map the ring file
+        let map = unsafe { capture_map(file.as_raw_fd() as i64, len) };
+        if map.is_null() {
+            let errno = io::Error::last_os_error();
+            return Err(errno.into());
+        }
+        let this = Self { map, len, capacity };
+
+        // Keep a matching existing ring so the pre-restart window survives, otherwise initialize the header
+        let mut header = [0; 16];
+        header[..8].copy_from_slice(&FILE_MAGIC);
+        header[8..16].copy_from_slice(&capacity.to_le_bytes());
+        if !existing || unsafe { slice::from_raw_parts(this.map, header.len()) } != header {
+            unsafe { ptr::copy_nonoverlapping(header.as_ptr(), this.map, header.len()) };
+            this.head().store(0, Ordering::Relaxed);
+        }
+        Ok(this)
+    }
+
+    /// Records a timestamped raw frame into the ring
+    pub fn record(&self, direction: Direction, payload: &[u8]) {
+        // Skip frames that cannot fit the ring
+        let total = RECORD_HEADER + payload.len() as u64;
+        if total > self.capacity {
+            return;
+        }
+
+        // Build the record header with the wall-clock timestamp
+        let nanos =
+            (SystemTime::now().duration_since(SystemTime::UNIX_EPOCH)).map_or(0, |elapsed| elapsed.as_nanos() as u64);
+        let mut header = [0; RECORD_HEADER as usize];
+        header[..4].copy_from_slice(&RECORD_MAGIC);
+        header[4..12].copy_from_slice(&nanos.to_le_bytes());
+        header[12] = direction as u8;
+        header[13..17].copy_from_slice(&(payload.len() as u32).to_le_bytes());
+
+        // Reserve the record's range and copy it into the ring
+        let offset = self.head().fetch_add(total, Ordering::Relaxed);
+        self.copy(offset, &header);
+        self.copy(offset + RECORD_HEADER, payload);
+    }
+
+    /// The atomic logical write offset in the mapped header
+    fn head(&self) -> &AtomicU64 {
+        // The offset lives 8-byte aligned within the page-aligned mapping
+        unsafe { &*(self.map.add(16) as *const AtomicU64) }
+    }
+
+    /// Copies `data` into the ring data area at the logical `offset`, wrapping at the end of the ring
+    fn copy(&self, offset: u64, data: &[u8]) {
+        let pos = (offset % self.capacity) as usize;
+        let until_end = self.capacity as usize - pos;
+        let (first, second) = data.split_at(data.len().min(until_end));
+        unsafe {
+            let ring = self.map.add(HEADER as usize);
+            ptr::copy_nonoverlapping(first.as_ptr(), ring.add(pos), first.len());
+            ptr::copy_nonoverlapping(second.as_ptr(), ring, second.len());
+        }
+    }
+}
+impl Drop for Recorder {
+    fn drop(&mut self) {
+        unsafe { capture_unmap(self.map, self.len) }
+    }
+}
+
+/// Dumps the surviving records of the capture ring file at `path` to stdout, oldest first
+pub fn dump(path: &str) -> Result<(), Error> {
+    // Read and validate the ring file
+    let data = fs::read(path)?;
+    if data.len() < HEADER as usize || data[..8] != FILE_MAGIC {
+        return Err(eio!("Not a capture ring file: {path}"));
+    }
+    let capacity = u64::from_le_bytes(data[8..16].try_into().expect("Header is too short"));
+    let head = u64::from_le_bytes(data[16..24].try_into().expect("Header is too short"));
+    if data.len() as u64 != HEADER + capacity {
+        return Err(eio!("Truncated capture ring file: {path}"));
+    }
+
+    // Reads `buf` from the ring data area at a logical offset, wrapping at the end of the ring
+    let ring = &data[HEADER as usize..];
+    let read = |offset: u64, buf: &mut [u8]| {
+        for (index, byte) in buf.iter_mut().enumerate() {
+            *byte = ring[((offset + index as u64) % capacity) as usize];
+        }
+    };
+
+    // Walk the records from the oldest surviving logical offset
+    let stdout = io::stdout();
+    let mut out = stdout.lock();
+    let mut offset = head.saturating_sub(capacity);
+    while offset + RECORD_HEADER <= head {
+        // Resynchronize on the next record magic, as the oldest record may be partially overwritten
+        let mut header = [0; RECORD_HEADER as usize];
+        read(offset, &mut header);
+        if header[..4] != RECORD_MAGIC {
+            offset += 1;
+            continue;
+        }
+
+        // Parse the record header, resynchronizing on implausible lengths and stopping at a torn record at the head
+        let nanos = u64::from_le_bytes(header[4..12].try_into().expect("Record header is too short"));
+        let length = u32::from_le_bytes(header[13..17].try_into().expect("Record header is too short")) as u64;
+        if RECORD_HEADER + length > capacity {
+            offset += 1;
+            continue;
+        }
+        if offset + RECORD_HEADER + length > head {
+            break;
+        }
+
+        // Print the record
+        let mut payload = vec![0; length as usize];
+        read(offset + RECORD_HEADER, &mut payload);
+        let direction = match header[12] {
+            0 => "serial->udp",
+            _ => "udp->serial",
+        };
+        let (secs, subsec) = (nanos / 1_000_000_000, nanos % 1_000_000_000);
+        writeln!(out, "[{secs}.{subsec:09}] {direction} {length} bytes: {}", escape(&payload))?;
+        offset += RECORD_HEADER + length;
+    }
+    Ok(())
+}
+
+/// Escapes nonprintable bytes for a single-line dump
+fn escape(data: &[u8]) -> String {
+    let mut escaped = String::with_capacity(data.len());
+    for &byte in data {
+        match byte {
+            b'\\' => escaped.push_str("\\\\"),
+            b' '..=b'~' => escaped.push(byte as char),
+            _ => escaped.push_str(&format!("\\x{byte:02x}")),
+        }
+    }
+    escaped
+}
@@ -1,36 +1,284 @@
 //! Implements a config object
 
-use crate::error::Error;
-use serde::Deserialize;
+use crate::{error::Error, framing::Framing, queue::Policy};
+use serde::{Deserialize, Deserializer};
 use std::{env, fs, path::Path};
 
+/// The I/O engine that drives the runloops
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub enum Engine {
+    /// Two blocking threads, one per direction
+    #[default]
+    Threads,
+    /// A single-threaded event loop polling nonblocking descriptors
+    EventLoop,
+    /// A single-threaded io_uring completion loop (Linux only)
+    IoUring,
+    /// A single thread that busy-polls nonblocking descriptors, trading a dedicated core for minimal wakeup latency
+    BusyPoll,
+}
+
+/// The flow control mode of a serial connection
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub enum FlowControl {
+    /// No flow control
+    #[default]
+    None,
+    /// RTS/CTS hardware flow control
+    Rtscts,
+}
+
 /// The serial config
-#[derive(Debug, Clone, Deserialize)]
+#[derive(Debug, Clone, PartialEq, Deserialize)]
 pub struct Serial {
     /// The path to the serial device
     pub device: String,
     /// The baudrate to use with the serial port
     #[serde(default = "Serial::baudrate_default")]
     pub baudrate: u64,
+    /// The flow control mode of the serial connection
+    #[serde(default)]
+    pub flow_control: FlowControl,
+    /// Whether to drain the kernel output buffers after each written packet
+    #[serde(default)]
+    pub drain: bool,
+    /// The minimum amount of bytes a blocking serial read waits for
+    #[serde(default = "Serial::vmin_default")]
+    pub vmin: u8,
+    /// The inter-byte timeout in deciseconds after which a blocking serial read returns early
+    #[serde(default)]
+    pub vtime: u8,
+    /// Whether to adaptively toggle between the configured read thresholds under load and `VMIN = 1` when idle
+    #[serde(default)]
+    pub adaptive: bool,
+    /// Whether to enable the kernel's low-latency mode on the device (`ASYNC_LOW_LATENCY` and the FTDI latency
+    /// timer; Linux only)
+    #[serde(default)]
+    pub low_latency: bool,
+    /// The framing mode that defines how the serial stream is split into frames
+    #[serde(default)]
+    pub framing: Framing,
 }
 impl Serial {
     /// The default baudrate
     const fn baudrate_default() -> u64 {
         115200
     }
+    /// The default minimum read size
+    const fn vmin_default() -> u8 {
+        1
+    }
+}
+
+/// The transport used for the datagram sockets
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub enum Transport {
+    /// UDP sockets
+    #[default]
+    Udp,
+    /// Unix-domain datagram sockets
+    Unix,
+    /// A TCP listener that streams framed chunks to accepted clients
+    Tcp,
 }
 
 /// The UDP configuration
 #[derive(Debug, Clone, Deserialize)]
 pub struct Udp {
-    /// The UDP address to listen on
-    pub listen: String,
-    /// The UDP address to send to
+    /// The transport used for the datagram sockets
     #[serde(default)]
-    pub send: Option<String>,
+    pub transport: Transport,
+    /// The address to listen on (a UDP address, or a socket path with the Unix-domain transport)
+    pub listen: String,
+    /// The addresses to send to (UDP addresses, or socket paths with the Unix-domain transport)
+    #[serde(default, deserialize_with = "Udp::send_deserialize")]
+    pub send: Vec<String>,
     /// The TTL for outgoing UDP packets
     #[serde(default)]
     pub ttl: u32,
+    /// The maximum payload size for outgoing UDP packets
+    #[serde(default = "Udp::mtu_default")]
+    pub mtu: usize,
+    /// The kernel-level receive buffer size of the listen socket in bytes (`0` keeps the kernel default)
+    #[serde(default)]
+    pub rcvbuf: usize,
+    /// The kernel-level send buffer size of the outgoing sockets in bytes (`0` keeps the kernel default)
+    #[serde(default)]
+    pub sndbuf: usize,
+    /// The maximum time in microseconds serial data may be delayed to coalesce it into larger UDP packets
+    #[serde(default)]
+    pub coalesce_us: u64,
+    /// The minimum payload size in bytes for LZ4 compression of outgoing packets (`0` disables compression)
+    #[serde(default)]
+    pub compress_min: usize,
+    /// The maximum amount of datagrams to move per syscall in batched I/O mode
+    #[serde(default = "Udp::batch_default")]
+    pub batch: usize,
+    /// The depth of the handoff queue between the serial drain thread and the UDP send thread
+    #[serde(default = "Udp::queue_default")]
+    pub queue: usize,
+    /// The depth of the bounded write queue between the UDP receiver and the serial writer
+    #[serde(default = "Udp::write_queue_default")]
+    pub write_queue: usize,
+    /// The policy applied when a datagram arrives while the write queue is full
+    #[serde(default)]
+    pub write_policy: Policy,
+    /// The depth of the per-client send queue of the TCP transport
+    #[serde(default = "Udp::client_queue_default")]
+    pub client_queue: usize,
+    /// Whether to disable Nagle's algorithm on accepted TCP connections
+    #[serde(default = "Udp::nodelay_default")]
+    pub nodelay: bool,
+    /// The time in microseconds the kernel may busy-poll the device queue on a blocking receive (`SO_BUSY_POLL`;
+    /// `0` keeps the kernel default)
+    #[serde(default)]
+    pub busy_poll_us: u64,
+    /// The maximum amount of dynamic subscribers to track (`0` disables subscriber mode)
+    #[serde(default)]
+    pub subscribers: usize,
+    /// The time in seconds after which an idle subscriber expires
+    #[serde(default = "Udp::subscriber_ttl_default")]
+    pub subscriber_ttl_secs: u64,
+}
+impl Udp {
+    /// The default maximum payload size (Ethernet MTU minus IPv4 and UDP headers)
+    const fn mtu_default() -> usize {
+        1472
+    }
+    /// The default batch size
+    const fn batch_default() -> usize {
+        1
+    }
+    /// The default handoff queue depth
+    const fn queue_default() -> usize {
+        64
+    }
+    /// The default write queue depth
+    const fn write_queue_default() -> usize {
+        64
+    }
+    /// The default per-client send queue depth
+    const fn client_queue_default() -> usize {
+        64
+    }
+    /// Whether Nagle's algorithm is disabled by default
+    const fn nodelay_default() -> bool {
+        true
+    }
+    /// The default subscriber expiry in seconds
+    const fn subscriber_ttl_default() -> u64 {
+        30
+    }
+
+    /// Deserializes the send addresses from either a single address or a list of addresses
+    fn send_deserialize<'de, D>(deserializer: D) -> Result<Vec<String>, D::Error>
+    where
+        D: Deserializer<'de>,
+    {
+        /// A single address or a list of addresses
+        #[derive(Deserialize)]
+        #[serde(untagged)]
+        enum OneOrMany {
+            /// A single address
+            One(String),
+            /// A list of addresses
+            Many(Vec<String>),
+        }
+
+        // Normalize a single address into a list
+        match OneOrMany::deserialize(deserializer)? {
+            OneOrMany::One(address) => Ok(vec![address]),
+            OneOrMany::Many(addresses) => Ok(addresses),
+        }
+    }
+}
+
+/// The buffer pool configuration
+#[derive(Debug, Clone, Deserialize)]
+pub struct Pool {
+    /// The amount of preallocated buffers
+    #[serde(default = "Pool::count_default")]
+    pub count: usize,
+    /// The capacity of a single buffer in bytes (`0` derives the capacity from the fastest configured baudrate)
+    #[serde(default = "Pool::size_default")]
+    pub size: usize,
+}
+impl Pool {
+    /// The default buffer count
+    const fn count_default() -> usize {
+        32
+    }
+    /// The default buffer capacity (`0` derives the capacity from the fastest configured baudrate)
+    const fn size_default() -> usize {
+        0
+    }
+}
+impl Default for Pool {
+    fn default() -> Self {
+        Self { count: Self::count_default(), size: Self::size_default() }
+    }
+}
+
+/// A serial<->UDP bridge configuration
+#[derive(Debug, Clone, Deserialize)]
+pub struct Bridge {
+    /// The serial device config
+    pub serial: Serial,
+    /// The UDP config
+    pub udp: Udp,
+}
+
+/// The thread scheduling configuration
+#[derive(Debug, Clone, Deserialize)]
+pub struct Sched {
+    /// The CPU core to pin the serial->UDP threads to (omitted = no pinning)
+    #[serde(default)]
+    pub serial2udp_cpu: Option<usize>,
+    /// The CPU core to pin the UDP->serial threads to (omitted = no pinning)
+    #[serde(default)]
+    pub udp2serial_cpu: Option<usize>,
+    /// The `SCHED_FIFO` realtime priority for the runloop threads (`0` keeps default scheduling)
+    #[serde(default)]
+    pub priority: u8,
+    /// The quiet period in microseconds after which the busy-poll engine downgrades to blocking waits
+    #[serde(default = "Sched::spin_idle_default")]
+    pub spin_idle_us: u64,
+}
+impl Sched {
+    /// The default busy-poll quiet period in microseconds (50ms)
+    const fn spin_idle_default() -> u64 {
+        50_000
+    }
+}
+impl Default for Sched {
+    fn default() -> Self {
+        Self { serial2udp_cpu: None, udp2serial_cpu: None, priority: 0, spin_idle_us: Self::spin_idle_default() }
+    }
+}
+
+/// The flight-recorder capture configuration
+#[derive(Debug, Clone, Deserialize)]
+pub struct Capture {
+    /// The path to the memory-mapped ring file (omitted = capture is disabled)
+    #[serde(default)]
+    pub file: Option<String>,
+    /// The capacity of the ring data area in bytes
+    #[serde(default = "Capture::size_default")]
+    pub size: usize,
+}
+impl Capture {
+    /// The default ring capacity (16 MiB)
+    const fn size_default() -> usize {
+        16 * 1024 * 1024
+    }
+}
+impl Default for Capture {
+    fn default() -> Self {
+        Self { file: None, size: Self::size_default() }
+    }
 }
 
 /// The logger configuration
@@ -41,16 +289,44 @@ pub struct Log {
     pub enabled: bool,
 }
 
+/// The statistics configuration
+#[derive(Debug, Default, Clone, Deserialize)]
+pub struct Stats {
+    /// The interval in seconds between periodic stats dumps (`0` disables the dump)
+    #[serde(default)]
+    pub interval_secs: u64,
+}
+
 /// The config
 #[derive(Debug, Clone, Deserialize)]
 pub struct Config {
-    /// The serial device config
-    pub serial: Serial,
-    /// The UDP config
-    pub udp: Udp,
+    /// The I/O engine that drives the runloops
+    #[serde(default)]
+    pub engine: Engine,
+    /// The serial device config of the default bridge
+    #[serde(default)]
+    pub serial: Option<Serial>,
+    /// The UDP config of the default bridge
+    #[serde(default)]
+    pub udp: Option<Udp>,
+    /// Additional serial<->UDP bridges
+    #[serde(default)]
+    pub bridge: Vec<Bridge>,
+    /// The buffer pool configuration
+    #[serde(default)]
+    pub pool: Pool,
+    /// The thread scheduling configuration
+    #[serde(default)]
+    pub sched: Sched,
+    /// The flight-recorder capture configuration
+    #[serde(default)]
+    pub capture: Capture,
     /// The logger configuration
     #[serde(default)]
     pub log: Log,
+    /// The statistics configuration
+    #[serde(default)]
+    pub stats: Stats,
 }
 impl Config {
     /// The default config path
@@ -77,6 +353,24 @@ impl Config {
         Err(eio!("Config file not found"))
     }
 
+    /// Collects the top-level `[serial]`/`[udp]` sections and the `[[bridge]]` array into the configured bridges
+    pub fn bridges(&self) -> Result<Vec<Bridge>, Error> {
+        // Treat the top-level sections as the first bridge
+        let mut bridges = Vec::new();
+        match (&self.serial, &self.udp) {
+            (Some(serial), Some(udp)) => bridges.push(Bridge { serial: serial.clone(), udp: udp.clone() }),
+            (None, None) => (),
+            _ => return Err(eio!("The top-level [serial] and [udp] sections must be configured together")),
+        }
+
+        // Append the bridge array and require at least one bridge
+        bridges.extend(self.bridge.iter().cloned());
+        match bridges.is_empty() {
+            true => Err(eio!("The config does not define any serial<->UDP bridge")),
+            false => Ok(bridges),
+        }
+    }
+
     /// Checks if a file exists
     fn file_exists(path: &str) -> Result<bool, Error> {
         Ok(Path::new(path).is_file())
@@ -0,0 +1,172 @@
+//! Implements the configurable framing engine for the serial byte stream
+
+use crate::error::Error;
+use serde::Deserialize;
+use std::time::Duration;
+
+/// The framing mode that defines how the serial byte stream is split into frames
+#[derive(Debug, Clone, PartialEq, Deserialize)]
+#[serde(tag = "mode", rename_all = "lowercase")]
+pub enum Framing {
+    /// Split the stream after a delimiter byte sequence
+    Delimiter {
+        /// The delimiter byte sequence (defaults to a newline)
+        #[serde(default = "Framing::delimiter_default")]
+        delimiter: Vec<u8>,
+    },
+    /// Split the stream into fixed-length frames
+    Fixed {
+        /// The frame length
+        length: usize,
+    },
+    /// Split the stream according to a length-prefix header (the emitted frames include the header)
+    Prefix {
+        /// The size of the length header in bytes
+        header: usize,
+        /// Whether the header is big-endian (defaults to true, i.e. network byte order)
+        #[serde(default = "Framing::big_endian_default")]
+        big_endian: bool,
+    },
+    /// Split the stream when the gap between two consecutive bytes exceeds a timeout
+    Timeout {
+        /// The inter-byte timeout in microseconds
+        timeout_us: u64,
+    },
+}
+impl Framing {
+    /// The default delimiter
+    fn delimiter_default() -> Vec<u8> {
+        vec![b'\n']
+    }
+    /// The default header endianness
+    const fn big_endian_default() -> bool {
+        true
+    }
+
+    /// Validates the framing parameters
+    pub fn validate(&self) -> Result<(), Error> {
+        match self {
+            Self::Delimiter { delimiter } if delimiter.is_empty() => Err(eio!("Framing delimiter is empty")),
+            Self::Fixed { length: 0 } => Err(eio!("Framing length is zero")),
+            Self::Prefix { header, .. } if !(1..=8).contains(header) => Err(eio!("Invalid framing header size")),
+            Self::Timeout { timeout_us: 0 } => Err(eio!("Framing timeout is zero")),
+            _ => Ok(()),
+        }
+    }
+}
+impl Default for Framing {
+    fn default() -> Self {
+        Self::Delimiter { delimiter: Self::delimiter_default() }
+    }
+}
+
+/// The framing engine that scans the raw serial stream and splits it into frames
+#[derive(Debug)]
+pub struct Framer {
+    /// The framing mode
+    framing: Framing,
+    /// The buffered stream data
+    buf: Vec<u8>,
+    /// The amount of buffered bytes that have already been consumed as frames
+    consumed: usize,
+    /// The watermark up to which buffered bytes are forcibly completed (inter-byte timeout or overlong frames)
+    complete: usize,
+}
+impl Framer {
+    /// The maximum frame length; longer frames are flushed as-is to bound memory usage
+    const FRAME_MAX: usize = 65536;
+
+    /// Creates a new framing engine
+    pub fn new(framing: Framing) -> Self {
+        Self { framing, buf: Vec::new(), consumed: 0, complete: 0 }
+    }
+
+    /// Appends a chunk of raw serial data to the scan buffer
+    pub fn push(&mut self, chunk: &[u8]) {
+        // Compact the buffer and append the chunk
+        self.buf.drain(..self.consumed);
+        self.complete = self.complete.saturating_sub(self.consumed);
+        self.consumed = 0;
+        self.buf.extend_from_slice(chunk);
+
+        // Forcibly complete overlong frames to bound memory usage
+        if self.buf.len() > Self::FRAME_MAX {
+            self.complete = self.buf.len();
+        }
+    }
+
+    /// Whether there is buffered data that has not been emitted as a frame yet
+    pub fn has_partial(&self) -> bool {
+        self.buf.len() > self.consumed
+    }
+
+    /// The configured inter-byte timeout, if any
+    pub fn timeout(&self) -> Option<Duration> {
+        match self.framing {
+            Framing::Timeout { timeout_us } => Some(Duration::from_micros(timeout_us)),
+            _ => None,
+        }
+    }
+
+    /// Marks all buffered data as one complete frame (called when the inter-byte timeout expires)
+    pub fn flush(&mut self) {
+        self.complete = self.buf.len();
+    }
+
+    /// Returns the next complete frame
+    pub fn next_frame(&mut self) -> Option<&[u8]> {
+        // Serve forcibly completed data first (inter-byte timeouts and overlong frames)
+        if self.complete > self.consumed {
+            let frame = &self.buf[self.consumed..self.complete];
+            self.consumed = self.complete;
+            return Some(frame);
+        }
+
+        // Scan the unconsumed data for the next frame boundary
+        let data = &self.buf[self.consumed..];
+        let len = match &self.framing {
+            Framing::Delimiter { delimiter } => {
+                // Find the end of the next delimiter sequence
+                let position = data.windows(delimiter.len()).position(|window| window == delimiter)?;
+                position + delimiter.len()
+            }
+            Framing::Fixed { length } => {
+                // Wait until an entire frame is buffered
+                match data.len() >= *length {
+                    true => *length,
+                    false => return None,
+                }
+            }
+            Framing::Prefix { header, big_endian } => {
+                // Parse the length header
+                let header_bytes = data.get(..*header)?;
+                let mut length = 0;
+                match big_endian {
+                    true => header_bytes.iter().for_each(|&byte| length = (length << 8) | byte as usize),
+                    false => header_bytes.iter().rev().for_each(|&byte| length = (length << 8) | byte as usize),
+                }
+
+                // Resync on an implausible length by flushing the buffered data as-is: a frame beyond `FRAME_MAX`
+                // could never be emitted coherently anyway, and trusting arbitrary line noise would stall the stream
+                // behind a bogus length (or overflow the addition outright)
+                let Some(total) = header.checked_add(length).filter(|total| *total <= Self::FRAME_MAX) else {
+                    self.complete = self.buf.len();
+                    return self.next_frame();
+                };
+
+                // Wait until the entire frame is buffered
+                match data.len() >= total {
+                    true => total,
+                    false => return None,
+                }
+            }
+            // Timeout-framed data is only completed via `flush`
+            Framing::Timeout { .. } => return None,
+        };
+
+        // Consume and return the frame
+        let frame = &self.buf[self.consumed..self.consumed + len];
+        self.consumed += len;
+        Some(frame)
+    }
+}
@@ -0,0 +1,21 @@
+#![doc = include_str!("../README.md")]
+
+#[macro_use]
+pub mod error;
+pub mod capture;
+pub mod config;
+pub mod framing;
+pub mod logger;
+pub mod lz4;
+pub mod net;
+pub mod pool;
+pub mod queue;
+pub mod reload;
+pub mod sched;
+pub mod serial;
+pub mod server;
+pub mod spsc;
+pub mod stats;
+pub mod subscribers;
+pub mod tcp;
+pub mod uring;
@@ -1,16 +1,44 @@
 //! The logging facility
 
-use std::{io, io::Write};
+use crate::pool::{Lease, Pool};
+use std::{
+    io::{self, BufWriter, Write},
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        mpsc::{self, Receiver, SyncSender},
+        Arc,
+    },
+    thread,
+};
 
-/// Logs messages
-#[derive(Debug, Clone, Copy)]
+/// Logs messages asynchronously through a dedicated writer thread
+///
+/// The hot path only copies the data into a leased buffer and queues it; a dedicated thread escapes and writes whole
+/// chunks through a locked, buffered stdout handle. If the queue is full, the chunk is dropped and counted so logging
+/// can never stall the I/O runloops.
+#[derive(Debug, Clone)]
 pub struct Logger {
-    _private: (),
+    /// The bounded queue into the writer thread
+    queue: SyncSender<Lease>,
+    /// The pool for log chunk buffers
+    pool: Pool,
+    /// The amount of log chunks dropped because the queue was full
+    dropped: Arc<AtomicU64>,
 }
 impl Logger {
-    /// Creates a new logger
-    pub const fn new() -> Self {
-        Self { _private: () }
+    /// The depth of the queue into the writer thread
+    const QUEUE_DEPTH: usize = 256;
+
+    /// Creates a new logger and spawns its writer thread
+    pub fn new(pool: Pool) -> Self {
+        let (queue, chunks) = mpsc::sync_channel(Self::QUEUE_DEPTH);
+        thread::spawn(|| Self::runloop(chunks));
+        Self { queue, pool, dropped: Arc::new(AtomicU64::new(0)) }
+    }
+
+    /// The amount of log chunks that have been dropped because the queue was full
+    pub fn dropped(&self) -> u64 {
+        self.dropped.load(Ordering::Relaxed)
     }
 
     /// Logs some data
@@ -18,19 +46,136 @@ impl Logger {
     where
         T: AsRef<[u8]>,
     {
-        // Write the bytes to stdout
-        let mut stdout = io::stdout();
-        for &byte in data.as_ref() {
-            // Check if the char can be printed
-            let mut is_valid = byte.is_ascii_alphanumeric();
-            is_valid |= byte.is_ascii_punctuation();
-            is_valid |= byte.is_ascii_whitespace();
-
-            // Print the char
-            match is_valid {
-                true => _ = write!(&mut stdout, "{}", byte as char),
-                false => _ = write!(&mut stdout, "\\x{byte:02x}"),
+        // Copy the data into a leased buffer and queue it for the writer thread
+        let mut chunk = self.pool.lease();
+        chunk.extend_from_slice(data.as_ref());
+        if self.queue.try_send(chunk).is_err() {
+            // Count the drop instead of ever stalling the hot path
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// The writer thread runloop that escapes and writes the queued chunks
+    fn runloop(chunks: Receiver<Lease>) {
+        // Write whole chunks through one locked, buffered writer
+        let stdout = io::stdout();
+        let mut out = BufWriter::new(stdout.lock());
+        let mut escaped = Vec::new();
+        while let Ok(chunk) = chunks.recv() {
+            // Escape and write the chunk
+            Self::escape_into(&chunk, &mut escaped);
+            let _ = out.write_all(&escaped);
+            drop(chunk);
+
+            // Drain whatever else is queued before flushing once
+            while let Ok(chunk) = chunks.try_recv() {
+                Self::escape_into(&chunk, &mut escaped);
+                let _ = out.write_all(&escaped);
+            }
+            let _ = out.flush();
+        }
+    }
+
+    /// The hex alphabet for the escape sequences
+    const HEX: &'static [u8; 16] = b"0123456789abcdef";
+    /// The per-byte printability table (ASCII alphanumerics, punctuation and whitespace)
+    const PRINTABLE: [bool; 256] = {
+        let mut table = [false; 256];
+        let mut byte = 0;
+        while byte < 256 {
+            let graphic = byte >= 0x20 && byte <= 0x7e;
+            let whitespace = byte == 0x09 || byte == 0x0a || byte == 0x0c || byte == 0x0d;
+            table[byte] = graphic || whitespace;
+            byte += 1;
+        }
+        table
+    };
+
+    /// Escapes the data for printing into `out`, replacing non-printable bytes with `\xNN` escapes
+    fn escape_into(data: &[u8], out: &mut Vec<u8>) {
+        out.clear();
+
+        // Classify whole blocks with the vectorized kernel where available
+        #[cfg(any(target_arch = "x86_64", target_arch = "aarch64"))]
+        let data = Self::escape_simd(data, out);
+
+        Self::escape_scalar(data, out);
+    }
+
+    /// Escapes the 16-byte blocks of `data` with SSE2 classification and returns the unprocessed tail
+    #[cfg(target_arch = "x86_64")]
+    fn escape_simd<'a>(data: &'a [u8], out: &mut Vec<u8>) -> &'a [u8] {
+        use std::arch::x86_64::*;
+
+        let mut blocks = data.chunks_exact(16);
+        for block in &mut blocks {
+            // Classify all 16 bytes at once (SSE2 is part of the x86_64 baseline, so this is always safe)
+            let mask = unsafe {
+                // Printable is the graphic range [0x20, 0x7e] plus tab/newline/form-feed/carriage-return
+                let bytes = _mm_loadu_si128(block.as_ptr() as *const __m128i);
+                let ge_space = _mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x1f));
+                let le_tilde = _mm_cmplt_epi8(bytes, _mm_set1_epi8(0x7f));
+                let graphic = _mm_and_si128(ge_space, le_tilde);
+                let tab_or_newline = _mm_or_si128(
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x09)),
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x0a)),
+                );
+                let ff_or_cr = _mm_or_si128(
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x0c)),
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x0d)),
+                );
+                let printable = _mm_or_si128(graphic, _mm_or_si128(tab_or_newline, ff_or_cr));
+                _mm_movemask_epi8(printable) as u32
             };
+
+            // Copy fully printable blocks wholesale and escape mixed blocks via the scalar path
+            match mask == 0xffff {
+                true => out.extend_from_slice(block),
+                false => Self::escape_scalar(block, out),
+            }
+        }
+        blocks.remainder()
+    }
+
+    /// Escapes the 16-byte blocks of `data` with NEON classification and returns the unprocessed tail
+    #[cfg(target_arch = "aarch64")]
+    fn escape_simd<'a>(data: &'a [u8], out: &mut Vec<u8>) -> &'a [u8] {
+        use std::arch::aarch64::*;
+
+        let mut blocks = data.chunks_exact(16);
+        for block in &mut blocks {
+            // Classify all 16 bytes at once (NEON is part of the aarch64 baseline, so this is always safe)
+            let all_printable = unsafe {
+                // Printable is the graphic range [0x20, 0x7e] plus tab/newline/form-feed/carriage-return
+                let bytes = vld1q_u8(block.as_ptr());
+                let graphic = vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0x20)), vcleq_u8(bytes, vdupq_n_u8(0x7e)));
+                let tab_or_newline = vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(0x09)), vceqq_u8(bytes, vdupq_n_u8(0x0a)));
+                let ff_or_cr = vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(0x0c)), vceqq_u8(bytes, vdupq_n_u8(0x0d)));
+                let printable = vorrq_u8(graphic, vorrq_u8(tab_or_newline, ff_or_cr));
+                vminvq_u8(printable) == 0xff
+            };
+
+            // Copy fully printable blocks wholesale and escape mixed blocks via the scalar path
+            match all_printable {
+                true => out.extend_from_slice(block),
+                false => Self::escape_scalar(block, out),
+            }
+        }
+        blocks.remainder()
+    }
+
+    /// Escapes `data` byte by byte, copying printable runs wholesale and hex-escaping the rest
+    fn escape_scalar(data: &[u8], out: &mut Vec<u8>) {
+        let mut run_start = 0;
+        for (index, &byte) in data.iter().enumerate() {
+            if !Self::PRINTABLE[byte as usize] {
+                // Copy the pending printable run and append the hex escape
+                out.extend_from_slice(&data[run_start..index]);
+                let (high, low) = (Self::HEX[(byte >> 4) as usize], Self::HEX[(byte & 0xf) as usize]);
+                out.extend_from_slice(&[b'\\', b'x', high, low]);
+                run_start = index + 1;
+            }
         }
+        out.extend_from_slice(&data[run_start..]);
     }
 }
@@ -0,0 +1,156 @@
+//! Implements a minimal LZ4 block codec for outbound datagram compression
+//!
+//! The compressor emits the standard LZ4 block format (greedy parsing over a small hash table), so any stock LZ4
+//! decoder can unpack the payloads. Compressed datagrams are marked with a [`MAGIC`] prefix followed by the
+//! little-endian `u16` size of the raw payload, so receivers can tell compressed and raw datagrams apart.
+
+use crate::error::Error;
+
+/// The magic prefix that marks a compressed datagram (the first byte is invalid UTF-8, so the prefix can never occur
+/// in ASCII telemetry)
+pub const MAGIC: [u8; 4] = [0xf5, b'L', b'Z', b'4'];
+
+/// The minimum match length of the LZ4 block format
+const MIN_MATCH: usize = 4;
+/// The amount of trailing bytes that must stay literals per the LZ4 spec
+const LAST_LITERALS: usize = 5;
+/// The minimum remaining length for starting another match per the LZ4 spec
+const MF_LIMIT: usize = 12;
+/// The amount of bits of the match-finder hash table
+const HASH_BITS: usize = 12;
+
+/// An LZ4 block compressor with a preallocated match-finder table
+pub struct Compressor {
+    /// The hash table mapping four-byte sequences to their last source position plus one (zero marks an empty slot)
+    table: Vec<u32>,
+}
+impl Compressor {
+    /// Creates a new compressor
+    pub fn new() -> Self {
+        Self { table: vec![0; 1 << HASH_BITS] }
+    }
+
+    /// Compresses `src` into an LZ4 block appended to `dst`
+    pub fn compress(&mut self, src: &[u8], dst: &mut Vec<u8>) {
+        // Reset the match-finder table and greedily emit matches against earlier positions
+        self.table.fill(0);
+        let mut anchor = 0;
+        if src.len() >= MF_LIMIT {
+            let match_end = src.len() - LAST_LITERALS;
+            let mut pos = 0;
+            while pos + MF_LIMIT <= src.len() {
+                // Look up and replace the last position of the current four-byte sequence
+                let seq = u32::from_le_bytes(src[pos..pos + MIN_MATCH].try_into().expect("Sequence is too short"));
+                let slot = &mut self.table[Self::hash(seq)];
+                let candidate = *slot as usize;
+                *slot = (pos + 1) as u32;
+
+                // Advance over unmatched positions; a candidate must verify and lie within the 64KiB offset window
+                let matched = candidate > 0
+                    && pos + 1 - candidate <= u16::MAX as usize
+                    && src[candidate - 1..candidate - 1 + MIN_MATCH] == src[pos..pos + MIN_MATCH];
+                if !matched {
+                    pos += 1;
+                    continue;
+                }
+
+                // Extend the match as far as the spec allows and emit it with the pending literals
+                let candidate = candidate - 1;
+                let mut length = MIN_MATCH;
+                while pos + length < match_end && src[candidate + length] == src[pos + length] {
+                    length += 1;
+                }
+                Self::emit(dst, &src[anchor..pos], Some(((pos - candidate) as u16, length)));
+                pos += length;
+                anchor = pos;
+            }
+        }
+
+        // Emit the trailing literals-only sequence
+        Self::emit(dst, &src[anchor..], None);
+    }
+
+    /// Emits one LZ4 sequence consisting of a literal run and an optional `(offset, length)` match
+    fn emit(dst: &mut Vec<u8>, literals: &[u8], matched: Option<(u16, usize)>) {
+        // Emit the token with the capped literal and match lengths
+        let match_length = matched.map_or(0, |(_, length)| length - MIN_MATCH);
+        dst.push(((literals.len().min(15) as u8) << 4) | match_length.min(15) as u8);
+
+        // Emit the extended literal length and the literals themselves
+        if literals.len() >= 15 {
+            Self::emit_length(dst, literals.len() - 15);
+        }
+        dst.extend_from_slice(literals);
+
+        // Emit the match offset and the extended match length
+        if let Some((offset, _)) = matched {
+            dst.extend_from_slice(&offset.to_le_bytes());
+            if match_length >= 15 {
+                Self::emit_length(dst, match_length - 15);
+            }
+        }
+    }
+
+    /// Emits an extended length in the LZ4 255-run encoding
+    fn emit_length(dst: &mut Vec<u8>, mut length: usize) {
+        while length >= 255 {
+            dst.push(255);
+            length -= 255;
+        }
+        dst.push(length as u8);
+    }
+
+    /// Hashes a four-byte sequence into a table slot
+    fn hash(seq: u32) -> usize {
+        (seq.wrapping_mul(2654435761) >> (32 - HASH_BITS)) as usize
+    }
+}
+
+/// Decompresses an LZ4 block into `dst` (e.g. for receivers that embed this crate)
+pub fn decompress(src: &[u8], dst: &mut Vec<u8>) -> Result<(), Error> {
+    let mut pos = 0;
+    loop {
+        // Read the token and the literal run
+        let token = *src.get(pos).ok_or_else(|| eio!("Truncated LZ4 block"))?;
+        pos += 1;
+        let literals = read_length(src, &mut pos, (token >> 4) as usize)?;
+        let run = (src.get(pos..pos + literals)).ok_or_else(|| eio!("Truncated LZ4 literal run"))?;
+        dst.extend_from_slice(run);
+        pos += literals;
+
+        // The last sequence of a block is literals-only
+        if pos == src.len() {
+            return Ok(());
+        }
+
+        // Read and copy the possibly self-overlapping match
+        let offset_bytes = (src.get(pos..pos + 2)).ok_or_else(|| eio!("Truncated LZ4 match offset"))?;
+        let offset = u16::from_le_bytes(offset_bytes.try_into().expect("Offset is too short")) as usize;
+        pos += 2;
+        if offset == 0 || offset > dst.len() {
+            return Err(eio!("Invalid LZ4 match offset: {offset}"));
+        }
+        let length = read_length(src, &mut pos, (token & 15) as usize)? + MIN_MATCH;
+        let start = dst.len() - offset;
+        for index in 0..length {
+            dst.push(dst[start + index]);
+        }
+    }
+}
+
+/// Reads an LZ4 length field with its 255-run extension if the nibble is saturated
+fn read_length(src: &[u8], pos: &mut usize, nibble: usize) -> Result<usize, Error> {
+    // Accumulate the extension bytes until a non-saturated byte terminates the run
+    let mut length = nibble;
+    if nibble == 15 {
+        loop {
+            let byte = *src.get(*pos).ok_or_else(|| eio!("Truncated LZ4 length field"))?;
+            *pos += 1;
+            length += byte as usize;
+            if byte != 255 {
+                break;
+            }
+        }
+    }
+    Ok(length)
+}
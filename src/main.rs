@@ -1,22 +1,49 @@
-#![doc = include_str!("../README.md")]
-
-#[macro_use]
-pub mod error;
-pub mod config;
-pub mod logger;
-pub mod serial;
-pub mod server;
-
-use crate::{config::Config, error::Error, server::Server};
-use std::process;
+use serial_server::{capture, config::Config, eio, error::Error, reload, server::Server};
+use std::{env, mem, process};
 
 pub fn main() {
     /// The real main function
     fn _main() -> Result<(), Error> {
-        // Parse the args and start the server
-        let config = Config::load()?;
-        let server = Server::new(config)?;
-        server.runloop()
+        // Dump a capture ring file instead of serving if requested
+        if env::args().nth(1).as_deref() == Some("dump") {
+            let path = env::args().nth(2).ok_or_else(|| eio!("Usage: serial-server dump <capture-file>"))?;
+            return capture::dump(&path);
+        }
+
+        // Serve, reloading the config on SIGHUP while keeping unchanged serial devices open
+        reload::init()?;
+        let mut config = Config::load()?;
+        let mut previous = None;
+        let mut serials = Vec::new();
+        loop {
+            // Build the server from the config; a broken reloaded config must not take down a running server, so fall
+            // back to the last working config instead (on the very first start there is nothing to fall back to)
+            let server = match Server::with_serials(config.clone(), mem::take(&mut serials)) {
+                Ok(server) => server,
+                Err(error) => match previous.take() {
+                    Some(fallback) => {
+                        eprintln!("Cannot apply the new configuration ({error}), keeping the previous one");
+                        config = fallback;
+                        continue;
+                    }
+                    None => return Err(error),
+                },
+            };
+            previous = Some(config);
+
+            // Run the server until a reload is requested, then re-read the config
+            server.runloop()?;
+            serials = server.into_serials();
+            reload::clear();
+            eprintln!("Reloading the configuration");
+            config = match Config::load() {
+                Ok(reloaded) => reloaded,
+                Err(error) => {
+                    eprintln!("Cannot re-read the configuration ({error}), keeping the previous one");
+                    previous.take().expect("There is no previous configuration")
+                }
+            };
+        }
     }
 
     // Call the real main function
@@ -0,0 +1,282 @@
+//! Provides OS-specific implementations for batched datagram I/O
+
+use std::{
+    io, mem,
+    net::{Ipv4Addr, SocketAddr, TcpListener, UdpSocket},
+    os::{
+        fd::{AsRawFd, RawFd},
+        unix::net::UnixDatagram,
+    },
+    time::Duration,
+};
+
+extern "C" {
+    // int32_t udp_recv_batch(int64_t fd, uint8_t* bufs, uint64_t stride, uint64_t* lens, uint64_t* peers,
+    //     uint32_t count)
+    fn udp_recv_batch(fd: i64, bufs: *mut u8, stride: u64, lens: *mut u64, peers: *mut u64, count: u32) -> i32;
+
+    // int32_t udp_send_batch(int64_t fd, const uint8_t* bufs, uint64_t stride, const uint64_t* lens, uint32_t count)
+    fn udp_send_batch(fd: i64, bufs: *const u8, stride: u64, lens: *const u64, count: u32) -> i32;
+
+    // int32_t io_poll_readable(const int32_t* fds, uint32_t count, int32_t timeout_ms)
+    fn io_poll_readable(fds: *const i32, count: u32, timeout_ms: i32) -> i32;
+
+    // int32_t udp_set_buffers(int64_t fd, int64_t rcvbuf, int64_t sndbuf)
+    fn udp_set_buffers(fd: i64, rcvbuf: i64, sndbuf: i64) -> i32;
+
+    // int32_t udp_set_busy_poll(int64_t fd, int64_t usec)
+    fn udp_set_busy_poll(fd: i64, usec: i64) -> i32;
+}
+
+/// A bound datagram socket of one of the supported transports
+///
+/// Both transports preserve datagram boundaries, so the batched I/O paths work on either; the Unix-domain transport
+/// skips the UDP/IP stack entirely for same-host consumers
+pub enum Transport {
+    /// A UDP socket
+    Udp(UdpSocket),
+    /// A Unix-domain datagram socket
+    Unix(UnixDatagram),
+    /// A TCP listener whose accepted clients are serviced by the TCP fan-out
+    Tcp(TcpListener),
+}
+impl Transport {
+    /// Enables or disables nonblocking mode on the socket
+    pub fn set_nonblocking(&self, nonblocking: bool) -> io::Result<()> {
+        match self {
+            Self::Udp(socket) => socket.set_nonblocking(nonblocking),
+            Self::Unix(socket) => socket.set_nonblocking(nonblocking),
+            Self::Tcp(listener) => listener.set_nonblocking(nonblocking),
+        }
+    }
+
+    /// Sends a datagram to the socket's connected peer (datagram transports only)
+    pub fn send(&self, buf: &[u8]) -> io::Result<usize> {
+        match self {
+            Self::Udp(socket) => socket.send(buf),
+            Self::Unix(socket) => socket.send(buf),
+            Self::Tcp(_) => Err(io::Error::from(io::ErrorKind::Unsupported)),
+        }
+    }
+
+    /// Sends a datagram to the given UDP address (UDP transport only)
+    pub fn send_to(&self, buf: &[u8], address: &SocketAddr) -> io::Result<usize> {
+        match self {
+            Self::Udp(socket) => socket.send_to(buf, address),
+            Self::Unix(_) | Self::Tcp(_) => Err(io::Error::from(io::ErrorKind::Unsupported)),
+        }
+    }
+
+    /// Sends a datagram to the given socket path (Unix-domain transport only)
+    pub fn send_to_path(&self, buf: &[u8], path: &str) -> io::Result<usize> {
+        match self {
+            Self::Unix(socket) => socket.send_to(buf, path),
+            Self::Udp(_) | Self::Tcp(_) => Err(io::Error::from(io::ErrorKind::Unsupported)),
+        }
+    }
+}
+impl AsRawFd for Transport {
+    fn as_raw_fd(&self) -> RawFd {
+        match self {
+            Self::Udp(socket) => socket.as_raw_fd(),
+            Self::Unix(socket) => socket.as_raw_fd(),
+            Self::Tcp(listener) => listener.as_raw_fd(),
+        }
+    }
+}
+
+/// Resizes the kernel-level receive and send buffers of a socket (`0` keeps the kernel default)
+pub fn set_buffers(socket: &impl AsRawFd, rcvbuf: usize, sndbuf: usize) -> io::Result<()> {
+    // Resize the socket buffers
+    let result = unsafe { udp_set_buffers(socket.as_raw_fd() as i64, rcvbuf as i64, sndbuf as i64) };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(errno);
+    }
+    Ok(())
+}
+
+/// Configures the time in microseconds the kernel may busy-poll the device queue on a blocking receive
+/// (`SO_BUSY_POLL`; a no-op on platforms without the option)
+pub fn set_busy_poll(socket: &impl AsRawFd, usec: u64) -> io::Result<()> {
+    // Configure the busy-poll time
+    let result = unsafe { udp_set_busy_poll(socket.as_raw_fd() as i64, usec as i64) };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(errno);
+    }
+    Ok(())
+}
+
+/// Waits until one of the descriptors becomes readable or the timeout expires and returns a bitmask of the readable
+/// descriptors (bit `n` for `fds[n]`; `None` waits forever)
+pub fn poll_readable(fds: &[RawFd], timeout: Option<Duration>) -> io::Result<u32> {
+    // Prepare the timeout
+    let timeout_ms = match timeout {
+        Some(timeout) => i32::try_from(timeout.as_millis()).unwrap_or(i32::MAX),
+        None => -1,
+    };
+
+    // Poll the descriptors
+    let readable = unsafe { io_poll_readable(fds.as_ptr(), fds.len() as u32, timeout_ms) };
+    if readable < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(errno);
+    }
+    Ok(readable as u32)
+}
+
+/// A preallocated set of datagram buffers that can be received or sent in a single syscall
+pub struct Batch {
+    /// The flat buffer backing all datagram slots
+    bufs: Vec<u8>,
+    /// The per-slot datagram lengths
+    lens: Vec<u64>,
+    /// The per-slot packed IPv4 peer addresses (`0` if the peer is unknown)
+    peers: Vec<u64>,
+    /// The size of a single datagram slot
+    stride: usize,
+    /// The amount of populated slots
+    len: usize,
+    /// The amount of received datagrams that have been truncated because they exceeded a slot
+    truncated: u64,
+}
+impl Batch {
+    /// The maximum amount of datagrams per batch (must match `BATCH_MAX` in the C shim)
+    pub const MAX: usize = 64;
+
+    /// Creates a new batch with `count` slots of `stride` bytes each
+    pub fn new(count: usize, stride: usize) -> Self {
+        let count = count.clamp(1, Self::MAX);
+        Self {
+            bufs: vec![0; count * stride],
+            lens: vec![0; count],
+            peers: vec![0; count],
+            stride,
+            len: 0,
+            truncated: 0,
+        }
+    }
+
+    /// The amount of populated slots
+    pub fn len(&self) -> usize {
+        self.len
+    }
+    /// Whether the batch is empty or not
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+    /// The datagram in the given slot
+    pub fn datagram(&self, index: usize) -> &[u8] {
+        let start = index * self.stride;
+        &self.bufs[start..start + self.lens[index] as usize]
+    }
+    /// The peer that sent the datagram in the given slot, if it is a known IPv4 peer
+    pub fn peer(&self, index: usize) -> Option<SocketAddr> {
+        match self.peers[index] {
+            0 => None,
+            packed => {
+                // Unpack the address and port
+                let ip = Ipv4Addr::from((packed >> 16) as u32);
+                Some(SocketAddr::from((ip, packed as u16)))
+            }
+        }
+    }
+
+    /// Receives up to a batch of datagrams in a single syscall, blocking until at least one is available
+    pub fn recv(&mut self, socket: &impl AsRawFd) -> io::Result<usize> {
+        // Receive the datagrams
+        let count = self.lens.len() as u32;
+        let received = unsafe {
+            udp_recv_batch(
+                socket.as_raw_fd() as i64,
+                self.bufs.as_mut_ptr(),
+                self.stride as u64,
+                self.lens.as_mut_ptr(),
+                self.peers.as_mut_ptr(),
+                count,
+            )
+        };
+        if received < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        self.len = received as usize;
+
+        // Detect and clamp truncated datagrams (`MSG_TRUNC` reports the real length of oversized datagrams)
+        for len in &mut self.lens[..self.len] {
+            if *len > self.stride as u64 {
+                *len = self.stride as u64;
+                self.truncated += 1;
+            }
+        }
+        Ok(self.len)
+    }
+
+    /// Takes the amount of received datagrams that have been truncated because they exceeded a slot since the last
+    /// call
+    pub fn take_truncated(&mut self) -> u64 {
+        mem::take(&mut self.truncated)
+    }
+
+    /// Appends a datagram to the batch and returns whether there was a free slot
+    pub fn push(&mut self, payload: &[u8]) -> bool {
+        // Reject the payload if the batch is full or the payload does not fit into a slot
+        if self.len == self.lens.len() || payload.len() > self.stride {
+            return false;
+        }
+
+        // Copy the payload into the next free slot
+        let start = self.len * self.stride;
+        self.bufs[start..start + payload.len()].copy_from_slice(payload);
+        self.lens[self.len] = payload.len() as u64;
+        self.peers[self.len] = 0;
+        self.len += 1;
+        true
+    }
+
+    /// Discards all pending datagrams
+    pub fn clear(&mut self) {
+        self.len = 0;
+    }
+
+    /// Sends all pending datagrams to the socket's connected peer and clears the batch
+    pub fn send(&mut self, socket: &impl AsRawFd) -> io::Result<()> {
+        self.send_socket(socket)?;
+        self.len = 0;
+        Ok(())
+    }
+
+    /// Fans all pending datagrams out to each socket's connected peer and clears the batch
+    pub fn send_all<'a, I, S>(&mut self, sockets: I) -> io::Result<()>
+    where
+        I: IntoIterator<Item = &'a S>,
+        S: AsRawFd + 'a,
+    {
+        // Send the same slots over every socket without copying the payloads
+        for socket in sockets {
+            self.send_socket(socket)?;
+        }
+        self.len = 0;
+        Ok(())
+    }
+
+    /// Sends all pending datagrams to the socket's connected peer, without clearing the batch
+    fn send_socket(&self, socket: &impl AsRawFd) -> io::Result<()> {
+        // Send the pending datagrams, retrying if the kernel accepts only a part of the batch
+        let mut sent = 0;
+        while sent < self.len {
+            // Send the remaining datagrams in a single syscall
+            let bufs = unsafe { self.bufs.as_ptr().add(sent * self.stride) };
+            let lens = unsafe { self.lens.as_ptr().add(sent) };
+            let count = (self.len - sent) as u32;
+            let result = unsafe { udp_send_batch(socket.as_raw_fd() as i64, bufs, self.stride as u64, lens, count) };
+            if result < 0 {
+                let errno = io::Error::last_os_error();
+                return Err(errno);
+            }
+            sent += result as usize;
+        }
+        Ok(())
+    }
+}
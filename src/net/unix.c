@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/// The maximum amount of datagrams per batch
+#define BATCH_MAX 64
+
+/// The maximum amount of descriptors per poll set
+#define POLL_MAX 32
+
+/**
+ * @brief Waits until one of the descriptors becomes readable or the timeout expires
+ *
+ * @param fds The file descriptors to wait for (at most `POLL_MAX`)
+ * @param count The amount of file descriptors
+ * @param timeout_ms The maximum time to wait in milliseconds (`-1` to wait forever)
+ * @return A bitmask of the readable descriptors (bit `n` for `fds[n]`), `0` on timeout or `-1` in case of an error
+ */
+int32_t io_poll_readable(const int32_t* fds, uint32_t count, int32_t timeout_ms) {
+    // Prepare the poll set
+    struct pollfd pollfds[POLL_MAX];
+    if (count > POLL_MAX) {
+        count = POLL_MAX;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        pollfds[i].fd = (int)fds[i];
+        pollfds[i].events = POLLIN;
+        pollfds[i].revents = 0;
+    }
+
+    // Poll the descriptors and collect the readable ones
+    int ready = poll(pollfds, count, timeout_ms);
+    if (ready < 0) {
+        return -1;
+    }
+    int32_t readable = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if ((pollfds[i].revents & (POLLIN | POLLERR | POLLHUP)) != 0) {
+            readable |= (int32_t)1 << i;
+        }
+    }
+    return readable;
+}
+
+/**
+ * @brief Resizes the kernel-level receive and send buffers of a socket
+ *
+ * @param fd The socket file descriptor to configure
+ * @param rcvbuf The receive buffer size in bytes (`0` keeps the kernel default)
+ * @param sndbuf The send buffer size in bytes (`0` keeps the kernel default)
+ * @return `0` or `-1` in case of an error
+ */
+int32_t udp_set_buffers(int64_t fd, int64_t rcvbuf, int64_t sndbuf) {
+    // Resize the receive buffer
+    if (rcvbuf > 0) {
+        int size = (int)rcvbuf;
+        if (setsockopt((int)fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) != 0) {
+            return -1;
+        }
+    }
+
+    // Resize the send buffer
+    if (sndbuf > 0) {
+        int size = (int)sndbuf;
+        if (setsockopt((int)fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Configures the time the kernel may busy-poll the device queue on a blocking receive
+ *
+ * @param fd The socket file descriptor to configure
+ * @param usec The busy-poll time in microseconds
+ * @return `0` or `-1` in case of an error
+ *
+ * @note On platforms without `SO_BUSY_POLL` this call is a no-op
+ */
+int32_t udp_set_busy_poll(int64_t fd, int64_t usec) {
+#ifdef SO_BUSY_POLL
+    int value = (int)usec;
+    if (setsockopt((int)fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) != 0) {
+        return -1;
+    }
+#else
+    (void)fd;
+    (void)usec;
+#endif
+    return 0;
+}
+
+/**
+ * @brief Packs an IPv4 peer address into a single nonzero integer (address in the upper bits, port in the lower 16)
+ *
+ * @param addr The source address of a received datagram
+ * @return The packed address or `0` if the peer is not an IPv4 peer
+ */
+static uint64_t udp_pack_peer(const struct sockaddr_storage* addr) {
+    if (addr->ss_family != AF_INET) {
+        return 0;
+    }
+    const struct sockaddr_in* addr4 = (const struct sockaddr_in*)addr;
+    return ((uint64_t)ntohl(addr4->sin_addr.s_addr) << 16) | (uint64_t)ntohs(addr4->sin_port);
+}
+
+/**
+ * @brief Receives up to `count` datagrams in a single syscall
+ *
+ * @param fd The socket file descriptor to receive from
+ * @param bufs The flat buffer backing the datagram slots (`count` slots of `stride` bytes each)
+ * @param stride The size of a single datagram slot
+ * @param lens The target array for the received datagram lengths (may exceed `stride` if a datagram was truncated)
+ * @param peers The target array for the packed IPv4 peer addresses (`0` if the peer is not an IPv4 peer)
+ * @param count The amount of datagram slots
+ * @return The amount of datagrams received or `-1` in case of an error
+ *
+ * @note This call blocks until at least one datagram is available and then drains whatever else the kernel has queued
+ */
+int32_t udp_recv_batch(int64_t fd, uint8_t* bufs, uint64_t stride, uint64_t* lens, uint64_t* peers, uint32_t count) {
+#ifndef __linux__
+    // Fall back to one datagram per syscall on platforms without `recvmmsg`
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    ssize_t received = recvfrom((int)fd, bufs, (size_t)stride, 0, (struct sockaddr*)&addr, &addr_len);
+    if (received < 0) {
+        return -1;
+    }
+    (void)count;
+    lens[0] = (uint64_t)received;
+    peers[0] = udp_pack_peer(&addr);
+    return 1;
+#else
+    // Prepare the message headers
+    struct iovec iovecs[BATCH_MAX];
+    struct mmsghdr msgs[BATCH_MAX];
+    struct sockaddr_storage addrs[BATCH_MAX];
+    if (count > BATCH_MAX) {
+        count = BATCH_MAX;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = bufs + (uint64_t)i * stride;
+        iovecs[i].iov_len = (size_t)stride;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        memset(&addrs[i], 0, sizeof(addrs[i]));
+    }
+
+    // Receive the datagrams and copy out the lengths and peer addresses; `MSG_TRUNC` reports the real length of
+    // datagrams that exceed a slot, so truncation can be detected by the caller
+    int received = recvmmsg((int)fd, msgs, count, MSG_WAITFORONE | MSG_TRUNC, NULL);
+    if (received < 0) {
+        return -1;
+    }
+    for (int i = 0; i < received; i++) {
+        lens[i] = (uint64_t)msgs[i].msg_len;
+        peers[i] = udp_pack_peer(&addrs[i]);
+    }
+    return (int32_t)received;
+#endif
+}
+
+/**
+ * @brief Sends up to `count` datagrams to the socket's connected peer in a single syscall
+ *
+ * @param fd The socket file descriptor to send over
+ * @param bufs The flat buffer backing the datagram slots (`count` slots of `stride` bytes each)
+ * @param stride The size of a single datagram slot
+ * @param lens The per-slot datagram lengths
+ * @param count The amount of datagrams to send
+ * @return The amount of datagrams sent or `-1` in case of an error
+ */
+int32_t udp_send_batch(int64_t fd, const uint8_t* bufs, uint64_t stride, const uint64_t* lens, uint32_t count) {
+#ifndef __linux__
+    // Fall back to one datagram per syscall on platforms without `sendmmsg`
+    for (uint32_t i = 0; i < count; i++) {
+        ssize_t sent = send((int)fd, bufs + (uint64_t)i * stride, (size_t)lens[i], 0);
+        if (sent < 0) {
+            return i > 0 ? (int32_t)i : -1;
+        }
+    }
+    return (int32_t)count;
+#else
+    // Prepare the message headers
+    struct iovec iovecs[BATCH_MAX];
+    struct mmsghdr msgs[BATCH_MAX];
+    if (count > BATCH_MAX) {
+        count = BATCH_MAX;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = (void*)(uintptr_t)(bufs + (uint64_t)i * stride);
+        iovecs[i].iov_len = (size_t)lens[i];
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Send the datagrams
+    int sent = sendmmsg((int)fd, msgs, count, 0);
+    if (sent < 0) {
+        return -1;
+    }
+    return (int32_t)sent;
+#endif
+}
@@ -0,0 +1,76 @@
+//! Implements a preallocated buffer pool for allocation-free forwarding between the pipeline stages
+
+use std::{
+    mem,
+    ops::{Deref, DerefMut},
+    sync::{Arc, Mutex},
+};
+
+/// A fixed-size pool of preallocated, uniformly sized buffers
+#[derive(Debug, Clone)]
+pub struct Pool {
+    /// The free buffers
+    free: Arc<Mutex<Vec<Vec<u8>>>>,
+    /// The maximum amount of pooled buffers
+    count: usize,
+    /// The capacity of a single buffer
+    size: usize,
+}
+impl Pool {
+    /// Creates a new pool with `count` preallocated buffers of `size` bytes capacity each
+    pub fn new(count: usize, size: usize) -> Self {
+        let free = (0..count).map(|_| Vec::with_capacity(size)).collect();
+        Self { free: Arc::new(Mutex::new(free)), count, size }
+    }
+
+    /// The capacity of a single buffer
+    pub fn size(&self) -> usize {
+        self.size
+    }
+
+    /// Leases an empty buffer from the pool (falls back to a fresh allocation if the pool is exhausted)
+    pub fn lease(&self) -> Lease {
+        let mut free = self.free.lock().expect("Buffer pool is poisoned");
+        let buf = free.pop().unwrap_or_else(|| Vec::with_capacity(self.size));
+        drop(free);
+        Lease { buf, pool: self.clone() }
+    }
+
+    /// Leases a zero-filled buffer of the pool's buffer size (e.g. to read into)
+    pub fn lease_zeroed(&self) -> Lease {
+        let mut lease = self.lease();
+        lease.resize(self.size, 0);
+        lease
+    }
+}
+
+/// A leased buffer that returns itself to the pool on drop
+#[derive(Debug)]
+pub struct Lease {
+    /// The leased buffer
+    buf: Vec<u8>,
+    /// The pool the buffer returns to
+    pool: Pool,
+}
+impl Deref for Lease {
+    type Target = Vec<u8>;
+    fn deref(&self) -> &Self::Target {
+        &self.buf
+    }
+}
+impl DerefMut for Lease {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.buf
+    }
+}
+impl Drop for Lease {
+    fn drop(&mut self) {
+        // Return the buffer to the pool unless the pool is at capacity
+        let mut buf = mem::take(&mut self.buf);
+        let mut free = self.pool.free.lock().expect("Buffer pool is poisoned");
+        if free.len() < self.pool.count {
+            buf.clear();
+            free.push(buf);
+        }
+    }
+}
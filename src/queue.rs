@@ -0,0 +1,156 @@
+//! Implements a bounded handoff queue with a selectable overload policy
+
+use crate::reload;
+use serde::Deserialize;
+use std::{
+    collections::VecDeque,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Condvar, Mutex,
+    },
+    time::{Duration, Instant},
+};
+
+/// The interval at which a producer blocked on a full queue re-checks for a pending config reload
+const RELOAD_CHECK: Duration = Duration::from_millis(250);
+
+/// The policy applied when an item is pushed into a full queue
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub enum Policy {
+    /// Block the producer until the consumer makes room
+    #[default]
+    Block,
+    /// Drop the pushed item
+    DropNewest,
+    /// Drop the oldest queued item to make room for the pushed item
+    DropOldest,
+}
+
+/// A bounded multi-policy handoff queue
+///
+/// Unlike the lock-free SPSC ring, this queue trades a mutex for deterministic overload behavior: when the queue is
+/// full, the configured policy decides whether the producer blocks or which item is dropped. Dropped items are counted
+pub struct Queue<T> {
+    /// The queued items
+    items: Mutex<VecDeque<T>>,
+    /// The maximum amount of queued items
+    capacity: usize,
+    /// The policy applied when an item is pushed into the full queue
+    policy: Policy,
+    /// The amount of items that have been dropped because the queue was full
+    dropped: AtomicU64,
+    /// Signals the consumer that the queue has become non-empty
+    readable: Condvar,
+    /// Signals a blocked producer that the queue has room again
+    writable: Condvar,
+}
+impl<T> Queue<T> {
+    /// Creates a new queue with the given capacity and overload policy
+    pub fn new(capacity: usize, policy: Policy) -> Self {
+        Self {
+            items: Mutex::new(VecDeque::with_capacity(capacity.max(1))),
+            capacity: capacity.max(1),
+            policy,
+            dropped: AtomicU64::new(0),
+            readable: Condvar::new(),
+            writable: Condvar::new(),
+        }
+    }
+
+    /// The amount of items currently queued
+    pub fn len(&self) -> usize {
+        let items = self.items.lock().expect("Queue mutex is poisoned");
+        items.len()
+    }
+    /// Whether the queue is empty or not
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Takes the amount of items that have been dropped because the queue was full since the last call
+    pub fn take_dropped(&self) -> u64 {
+        self.dropped.swap(0, Ordering::Relaxed)
+    }
+
+    /// Pushes an item into the queue, applying the overload policy if the queue is full
+    pub fn push(&self, item: T) {
+        // Make room for the item according to the policy
+        let mut items = self.items.lock().expect("Queue mutex is poisoned");
+        if items.len() >= self.capacity {
+            match self.policy {
+                // Wait until the consumer makes room, bailing out on a pending config reload: the consumer exits at
+                // its loop top without draining, so an unbounded wait would deadlock the runloop teardown
+                Policy::Block => {
+                    while items.len() >= self.capacity {
+                        if reload::pending() {
+                            self.dropped.fetch_add(1, Ordering::Relaxed);
+                            return;
+                        }
+                        (items, _) = self.writable.wait_timeout(items, RELOAD_CHECK).expect("Queue mutex is poisoned");
+                    }
+                }
+                // Drop the pushed item
+                Policy::DropNewest => {
+                    self.dropped.fetch_add(1, Ordering::Relaxed);
+                    return;
+                }
+                // Drop the oldest queued item
+                Policy::DropOldest => {
+                    items.pop_front();
+                    self.dropped.fetch_add(1, Ordering::Relaxed);
+                }
+            }
+        }
+
+        // Queue the item and wake the consumer
+        items.push_back(item);
+        drop(items);
+        self.readable.notify_one();
+    }
+
+    /// Takes the next item out of the queue if one is available
+    pub fn try_pop(&self) -> Option<T> {
+        // Take the next item and wake a blocked producer
+        let mut items = self.items.lock().expect("Queue mutex is poisoned");
+        let item = items.pop_front()?;
+        drop(items);
+        self.writable.notify_one();
+        Some(item)
+    }
+
+    /// Takes the next item out of the queue, waiting up to `timeout` for the producer
+    pub fn pop_timeout(&self, timeout: Duration) -> Option<T> {
+        // Wait for the next item
+        let mut items = self.items.lock().expect("Queue mutex is poisoned");
+        let deadline = Instant::now() + timeout;
+        while items.is_empty() {
+            let remaining = deadline.saturating_duration_since(Instant::now());
+            if remaining.is_zero() {
+                return None;
+            }
+            (items, _) = self.readable.wait_timeout(items, remaining).expect("Queue mutex is poisoned");
+        }
+
+        // Take the item and wake a blocked producer
+        let item = items.pop_front().expect("Queue is empty despite the wakeup");
+        drop(items);
+        self.writable.notify_one();
+        Some(item)
+    }
+
+    /// Takes the next item out of the queue, waiting for the producer if the queue is empty
+    pub fn pop(&self) -> T {
+        // Wait for the next item
+        let mut items = self.items.lock().expect("Queue mutex is poisoned");
+        while items.is_empty() {
+            items = self.readable.wait(items).expect("Queue mutex is poisoned");
+        }
+
+        // Take the item and wake a blocked producer
+        let item = items.pop_front().expect("Queue is empty despite the wakeup");
+        drop(items);
+        self.writable.notify_one();
+        item
+    }
+}
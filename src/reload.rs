@@ -0,0 +1,78 @@
+//! Implements SIGHUP-triggered config reloading
+//!
+//! A `SIGHUP` requests a reload: the handler sets a flag, and the runloop threads observe it either at their loop tops
+//! or via `EINTR` from their interrupted blocking syscalls and exit cleanly. The server is then rebuilt from the
+//! re-read config, keeping the serial devices of unchanged `[serial]` sections open so the attached hardware never
+//! sees a close/reopen cycle.
+
+use crate::error::Error;
+use std::{io, sync::Mutex};
+
+extern "C" {
+    // int32_t reload_init(void)
+    fn reload_init() -> i32;
+
+    // int32_t reload_unmask(void)
+    fn reload_unmask() -> i32;
+
+    // int32_t reload_pending(void)
+    fn reload_pending() -> i32;
+
+    // void reload_clear(void)
+    fn reload_clear();
+
+    // uint64_t thread_current(void)
+    fn thread_current() -> u64;
+
+    // int32_t thread_interrupt(uint64_t thread)
+    fn thread_interrupt(thread: u64) -> i32;
+}
+
+/// The registered runloop threads to interrupt when a reload is requested
+static THREADS: Mutex<Vec<u64>> = Mutex::new(Vec::new());
+
+/// Installs the SIGHUP handler and masks the signal in the calling thread, so it is delivered to a runloop thread
+pub fn init() -> Result<(), Error> {
+    // Install the handler
+    let result = unsafe { reload_init() };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(errno.into());
+    }
+    Ok(())
+}
+
+/// Registers the calling runloop thread for reload interrupts
+pub fn register() -> Result<(), Error> {
+    // Unmask the signal in this thread
+    let result = unsafe { reload_unmask() };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(errno.into());
+    }
+
+    // Remember the thread for cross-thread interrupts
+    let thread = unsafe { thread_current() };
+    (THREADS.lock().expect("Reload registry is poisoned")).push(thread);
+    Ok(())
+}
+
+/// Whether a config reload has been requested
+pub fn pending() -> bool {
+    unsafe { reload_pending() != 0 }
+}
+
+/// Interrupts all registered runloop threads so their blocking syscalls return and the pending reload is observed
+pub fn interrupt_all() {
+    // Errors are ignored because threads may already have exited
+    let threads = THREADS.lock().expect("Reload registry is poisoned");
+    for &thread in threads.iter() {
+        unsafe { _ = thread_interrupt(thread) };
+    }
+}
+
+/// Clears the reload request and the thread registry before the next server run
+pub fn clear() {
+    (THREADS.lock().expect("Reload registry is poisoned")).clear();
+    unsafe { reload_clear() }
+}
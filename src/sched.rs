@@ -0,0 +1,36 @@
+//! Provides OS-specific thread scheduling controls for the runloop threads
+
+use crate::error::Error;
+use std::io;
+
+extern "C" {
+    // int32_t thread_set_affinity(int64_t cpu)
+    fn thread_set_affinity(cpu: i64) -> i32;
+
+    // int32_t thread_set_realtime(int32_t priority)
+    fn thread_set_realtime(priority: i32) -> i32;
+}
+
+/// Pins the calling thread to the given CPU core
+pub fn set_affinity(cpu: usize) -> Result<(), Error> {
+    // Pin the thread
+    let result = unsafe { thread_set_affinity(cpu as i64) };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(eio!("Cannot pin thread to CPU {cpu}: {errno}"));
+    }
+    Ok(())
+}
+
+/// Elevates the calling thread to the `SCHED_FIFO` realtime scheduling class with the given priority
+///
+/// Realtime scheduling usually requires elevated privileges (e.g. root or `CAP_SYS_NICE` on Linux)
+pub fn set_realtime(priority: u8) -> Result<(), Error> {
+    // Elevate the thread
+    let result = unsafe { thread_set_realtime(priority as i32) };
+    if result < 0 {
+        let errno = io::Error::last_os_error();
+        return Err(eio!("Cannot elevate thread to SCHED_FIFO priority {priority}: {errno}"));
+    }
+    Ok(())
+}
@@ -3,21 +3,46 @@
 use crate::error::Error;
 use std::{
     ffi::CString,
+    fs,
     io::{self, Read, Write},
+    os::fd::{AsRawFd, RawFd},
+    path::Path,
+    time::Duration,
 };
 
 extern "C" {
-    // int64_t serial_open(const char* path, uint64_t bauds)
-    fn serial_open(path: *const u8, bauds: u64) -> i64;
+    // int64_t serial_open(const char* path, uint64_t bauds, int32_t rtscts)
+    fn serial_open(path: *const u8, bauds: u64, rtscts: i32) -> i64;
+
+    // int32_t serial_tune(int64_t fd, uint8_t vmin, uint8_t vtime)
+    fn serial_tune(fd: i64, vmin: u8, vtime: u8) -> i32;
+
+    // int32_t serial_low_latency(int64_t fd)
+    fn serial_low_latency(fd: i64) -> i32;
+
+    // int64_t serial_openpt(uint8_t* path, uint64_t path_len)
+    fn serial_openpt(path: *mut u8, path_len: u64) -> i64;
 
     // int64_t serial_duplicate(int64_t fd)
     fn serial_duplicate(fd: i64) -> i64;
 
-    // int32_t serial_read_one(int64_t fd, uint8_t* buf)
-    fn serial_read_one(fd: i64, buf: *mut u8) -> i32;
+    // int64_t serial_read(int64_t fd, uint8_t* buf, uint64_t len)
+    fn serial_read(fd: i64, buf: *mut u8, len: u64) -> i64;
+
+    // int32_t serial_set_nonblocking(int64_t fd, int32_t enable)
+    fn serial_set_nonblocking(fd: i64, enable: i32) -> i32;
 
-    // int32_t serial_write_one(int64_t fd, const uint8_t* byte)
-    fn serial_write_one(fd: i64, byte: *const u8) -> i32;
+    // int32_t serial_poll(int64_t fd, int32_t timeout_ms)
+    fn serial_poll(fd: i64, timeout_ms: i32) -> i32;
+
+    // int32_t serial_poll_writable(int64_t fd, int32_t timeout_ms)
+    fn serial_poll_writable(fd: i64, timeout_ms: i32) -> i32;
+
+    // int64_t serial_write(int64_t fd, const uint8_t* buf, uint64_t len)
+    fn serial_write(fd: i64, buf: *const u8, len: u64) -> i64;
+
+    // int32_t serial_drain(int64_t fd)
+    fn serial_drain(fd: i64) -> i32;
 
     // void serial_close(int64_t fd)
     fn serial_close(fd: i64);
@@ -27,20 +52,116 @@ extern "C" {
 pub struct SerialDevice {
     /// The underlying file descriptor
     fd: i64,
+    /// Whether `flush` drains the kernel output buffers via `tcdrain` or is a no-op
+    drain: bool,
 }
 impl SerialDevice {
     /// Opens a serial device
-    pub fn new(path: &str, baudrate: u64) -> Result<Self, Error> {
+    ///
+    /// Standard baudrates are configured via their `Bxxx` constants; on Linux, arbitrary rates are applied via the
+    /// `termios2`/`BOTHER` interface
+    pub fn new(path: &str, baudrate: u64, rtscts: bool, drain: bool) -> Result<Self, Error> {
         // Prepare the path
         let path = CString::new(path)?;
 
         // Open the serial device
-        let fd = unsafe { serial_open(path.as_bytes_with_nul().as_ptr(), baudrate) };
+        let fd = unsafe { serial_open(path.as_bytes_with_nul().as_ptr(), baudrate, rtscts as i32) };
         if fd < 0 {
             let errno = io::Error::last_os_error();
             return Err(errno.into());
         }
-        Ok(Self { fd })
+        Ok(Self { fd, drain })
+    }
+
+    /// Reconfigures the `VMIN`/`VTIME` read thresholds of the device
+    ///
+    /// A blocking read waits until at least `vmin` bytes are buffered, but returns early if `vtime` deciseconds pass
+    /// between two bytes, so large thresholds batch sustained traffic in the kernel without stalling on its tail
+    pub fn tune(&self, vmin: u8, vtime: u8) -> io::Result<()> {
+        // Update the read thresholds
+        let result = unsafe { serial_tune(self.fd, vmin, vtime) };
+        if result < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(())
+    }
+
+    /// Enables the kernel's low-latency mode on the device (Linux only)
+    ///
+    /// Sets `ASYNC_LOW_LATENCY` via `TIOCSSERIAL`, so the driver pushes received bytes to the line discipline
+    /// immediately, and lowers the FTDI latency timer to 1ms where the driver exposes it via sysfs – default trigger
+    /// levels and the 16ms FTDI default add several milliseconds of driver-side buffering before a read can return
+    pub fn low_latency(&self, path: &str) -> Result<(), Error> {
+        // Set the driver-level low-latency flag
+        let result = unsafe { serial_low_latency(self.fd) };
+        if result < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno.into());
+        }
+
+        // Lower the FTDI latency timer if the driver exposes it for the device
+        if let Some(name) = Path::new(path).file_name().and_then(|name| name.to_str()) {
+            let sysfs = format!("/sys/bus/usb-serial/devices/{name}/latency_timer");
+            if Path::new(&sysfs).is_file() {
+                fs::write(&sysfs, "1")?;
+            }
+        }
+        Ok(())
+    }
+
+    /// Opens a pseudo-terminal master as a fake serial device and returns it together with the path to the slave side
+    ///
+    /// The slave side can be opened like a real serial device, which makes the pair useful as a loopback harness for
+    /// benchmarks and tests
+    pub fn openpt() -> Result<(Self, String), Error> {
+        // Open the master side
+        let mut path = [0; 256];
+        let fd = unsafe { serial_openpt(path.as_mut_ptr(), path.len() as u64) };
+        if fd < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno.into());
+        }
+
+        // Extract the NUL-terminated slave path
+        let len = path.iter().position(|byte| *byte == 0).unwrap_or(path.len());
+        let path = String::from_utf8_lossy(&path[..len]).to_string();
+        Ok((Self { fd, drain: false }, path))
+    }
+
+    /// Waits until the device has data to read or the timeout expires and returns whether data is available
+    pub fn poll(&self, timeout: Duration) -> io::Result<bool> {
+        // Poll the file descriptor for readability
+        let timeout_ms = i32::try_from(timeout.as_millis()).unwrap_or(i32::MAX);
+        let ready = unsafe { serial_poll(self.fd, timeout_ms) };
+        if ready < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(ready > 0)
+    }
+
+    /// Waits until the device can accept more output data or the timeout expires and returns whether it is writable
+    pub fn poll_writable(&self, timeout: Duration) -> io::Result<bool> {
+        // Poll the file descriptor for writability
+        let timeout_ms = i32::try_from(timeout.as_millis()).unwrap_or(i32::MAX);
+        let ready = unsafe { serial_poll_writable(self.fd, timeout_ms) };
+        if ready < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(ready > 0)
+    }
+
+    /// Enables or disables nonblocking mode on the device
+    pub fn set_nonblocking(&self, nonblocking: bool) -> io::Result<()> {
+        // Update the descriptor flags
+        let result = unsafe { serial_set_nonblocking(self.fd, nonblocking as i32) };
+        if result < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(())
     }
 
     /// Tries to clone the serial device by duplicating the underlying file descriptor
@@ -51,43 +172,47 @@ impl SerialDevice {
             let errno = io::Error::last_os_error();
             return Err(errno);
         }
-        Ok(Self { fd })
+        Ok(Self { fd, drain: self.drain })
     }
 }
 impl Read for SerialDevice {
     fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
-        for (pos, byte) in buf.iter_mut().enumerate() {
-            // Read next byte
-            let result = unsafe { serial_read_one(self.fd, byte) };
-            if result < 0 {
-                let errno = io::Error::last_os_error();
-                return Err(errno);
-            }
-
-            // Fast return if newline
-            if *byte == b'\n' {
-                return Ok(pos + 1);
-            }
+        // Read the next chunk in a single bulk syscall
+        let read = unsafe { serial_read(self.fd, buf.as_mut_ptr(), buf.len() as u64) };
+        if read < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
         }
-        Ok(buf.len())
+        Ok(read as usize)
     }
 }
 impl Write for SerialDevice {
     fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
-        for byte in buf.iter() {
-            // Write next byte
-            let result = unsafe { serial_write_one(self.fd, byte) };
+        // Write as many bytes as possible in a single bulk syscall
+        let written = unsafe { serial_write(self.fd, buf.as_ptr(), buf.len() as u64) };
+        if written < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(written as usize)
+    }
+    fn flush(&mut self) -> io::Result<()> {
+        // Drain the kernel output buffers if configured
+        if self.drain {
+            let result = unsafe { serial_drain(self.fd) };
             if result < 0 {
                 let errno = io::Error::last_os_error();
                 return Err(errno);
             }
         }
-        Ok(buf.len())
-    }
-    fn flush(&mut self) -> io::Result<()> {
         Ok(())
     }
 }
+impl AsRawFd for SerialDevice {
+    fn as_raw_fd(&self) -> RawFd {
+        self.fd as RawFd
+    }
+}
 impl Drop for SerialDevice {
     fn drop(&mut self) {
         unsafe { serial_close(self.fd) }
@@ -1,18 +1,107 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+/**
+ * @brief Translates a numeric baud rate into its `Bxxx` speed constant
+ *
+ * @param bauds The numeric baud rate
+ * @return The speed constant or `(speed_t)-1` if the rate is not a standard rate
+ */
+static speed_t serial_speed(uint64_t bauds) {
+    switch (bauds) {
+        case 1200: return B1200;
+        case 2400: return B2400;
+        case 4800: return B4800;
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+        case 500000: return B500000;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+#endif
+        default: return (speed_t)-1;
+    }
+}
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+/**
+ * @brief The kernel's `struct termios2` layout, declared locally because `<asm/termbits.h>` clashes with `<termios.h>`
+ */
+struct serial_termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+// The `termios2` ioctls and baud flags from `<asm/termbits.h>`
+#define SERIAL_TCGETS2 _IOR('T', 0x2A, struct serial_termios2)
+#define SERIAL_TCSETS2 _IOW('T', 0x2B, struct serial_termios2)
+#define SERIAL_CBAUD 0010017
+#define SERIAL_BOTHER 0010000
+
+/**
+ * @brief Configures an arbitrary baud rate via the `termios2`/`BOTHER` interface
+ *
+ * @param fd The device file descriptor
+ * @param bauds The numeric baud rate
+ * @return `0` or `-1` in case of an error
+ */
+static int serial_speed_other(int fd, uint64_t bauds) {
+    // Get the kernel-level device attributes
+    struct serial_termios2 tty2;
+    if (ioctl(fd, SERIAL_TCGETS2, &tty2) != 0) {
+        return -1;
+    }
+
+    // Replace the legacy speed constant with the raw numeric rate
+    tty2.c_cflag &= ~(tcflag_t)SERIAL_CBAUD;
+    tty2.c_cflag |= SERIAL_BOTHER;
+    tty2.c_ispeed = (speed_t)bauds;
+    tty2.c_ospeed = (speed_t)bauds;
+    if (ioctl(fd, SERIAL_TCSETS2, &tty2) != 0) {
+        return -1;
+    }
+    return 0;
+}
+#endif
+
 /**
  * @brief Opens a serial device file
- * 
+ *
  * @param path The path to open
  * @param bauds The baud rate to configure
+ * @param rtscts Whether to enable RTS/CTS hardware flow control
  * @return The device file descriptor or `-1` in case of an error
  */
-int64_t serial_open(const uint8_t* path, uint64_t bauds) {
+int64_t serial_open(const uint8_t* path, uint64_t bauds, int32_t rtscts) {
     // Open the device file nonblocking
     int devfile = open((const char*)path, O_RDWR | O_NONBLOCK);
     if (devfile < 0) {
@@ -31,12 +120,22 @@ int64_t serial_open(const uint8_t* path, uint64_t bauds) {
         return -1;
     }
 
-    // Set the speed
-    if (cfsetispeed(&tty, bauds) != 0) {
+    // Translate the numeric baud rate and set the speed; non-standard rates are applied via `termios2` after the
+    // regular attributes below, since `cfsetispeed` only accepts the classic `Bxxx` constants
+    speed_t speed = serial_speed(bauds);
+#ifndef __linux__
+    if (speed == (speed_t)-1) {
+        errno = EINVAL;
         return -1;
     }
-    if (cfsetospeed(&tty, bauds) != 0) {
-        return -1;
+#endif
+    if (speed != (speed_t)-1) {
+        if (cfsetispeed(&tty, speed) != 0) {
+            return -1;
+        }
+        if (cfsetospeed(&tty, speed) != 0) {
+            return -1;
+        }
     }
 
     // Disable parity generation on output and parity checking for input
@@ -46,14 +145,20 @@ int64_t serial_open(const uint8_t* path, uint64_t bauds) {
     // Use eight bit characters
     tty.c_cflag &= ~CSIZE;
     tty.c_cflag |= CS8;
-    // Disable hardware flow control
-    tty.c_cflag &= ~CRTSCTS;
+    // Enable or disable RTS/CTS hardware flow control
+    if (rtscts != 0) {
+        tty.c_cflag |= CRTSCTS;
+    } else {
+        tty.c_cflag &= ~CRTSCTS;
+    }
     // Enable receiving
     tty.c_cflag |= CREAD;
     // Ignore modem control lines
     tty.c_cflag |= CLOCAL;
     // Disable canonical mode
     tty.c_lflag &= ~ICANON;
+    // Disable echoing of input characters
+    tty.c_lflag &= ~(ECHO | ECHOE | ECHONL);
     // Disable INTR, QUIT, SUSP, or DSUSP signals
     tty.c_lflag &= ~ISIG;
     // Disable XON/XOFF
@@ -75,12 +180,273 @@ int64_t serial_open(const uint8_t* path, uint64_t bauds) {
     if (tcsetattr(devfile, TCSANOW, &tty) != 0) {
         return -1;
     }
+
+#ifdef __linux__
+    // Apply a non-standard baud rate via `termios2` now that the regular attributes are in place
+    if (speed == (speed_t)-1 && serial_speed_other(devfile, bauds) != 0) {
+        return -1;
+    }
+#endif
     return devfile;
 }
 
+/**
+ * @brief Reconfigures the `VMIN`/`VTIME` read thresholds of an open serial device
+ *
+ * @param fd The device file descriptor
+ * @param vmin The minimum amount of bytes a blocking read waits for
+ * @param vtime The inter-byte timeout in deciseconds
+ * @return `0` or `-1` in case of an error
+ */
+int32_t serial_tune(int64_t fd, uint8_t vmin, uint8_t vtime) {
+    // Get the device attributes
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        return -1;
+    }
+
+    // Update the read thresholds
+    tty.c_cc[VMIN] = vmin;
+    tty.c_cc[VTIME] = vtime;
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Enables the driver-level low-latency mode of a serial device
+ *
+ * Sets the `ASYNC_LOW_LATENCY` flag via `TIOCGSERIAL`/`TIOCSSERIAL`, so the driver pushes received bytes to the line
+ * discipline immediately instead of batching them behind the receive-FIFO trigger level or a flip-buffer timer
+ *
+ * @param fd The device file descriptor
+ * @return `0` or `-1` in case of an error (`ENOTSUP` on platforms without `TIOCSSERIAL`)
+ */
+int32_t serial_low_latency(int64_t fd) {
+#ifdef __linux__
+    // Get the driver-level device configuration
+    struct serial_struct info;
+    if (ioctl((int)fd, TIOCGSERIAL, &info) != 0) {
+        return -1;
+    }
+
+    // Set the low-latency flag
+    info.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl((int)fd, TIOCSSERIAL, &info) != 0) {
+        return -1;
+    }
+    return 0;
+#else
+    (void)fd;
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Opens a pseudo-terminal master as a fake serial device (e.g. for benchmarks and tests)
+ *
+ * @param path The target buffer for the NUL-terminated path to the slave side
+ * @param path_len The target buffer size
+ * @return The master file descriptor or `-1` in case of an error
+ */
+int64_t serial_openpt(uint8_t* path, uint64_t path_len) {
+    // Open and unlock the master side
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) {
+        return -1;
+    }
+    if (grantpt(master) != 0 || unlockpt(master) != 0) {
+        close(master);
+        return -1;
+    }
+
+    // Copy out the path to the slave side
+#ifdef __linux__
+    if (ptsname_r(master, (char*)path, (size_t)path_len) != 0) {
+        close(master);
+        return -1;
+    }
+#else
+    const char* name = ptsname(master);
+    if (name == NULL || strlen(name) + 1 > path_len) {
+        close(master);
+        return -1;
+    }
+    strcpy((char*)path, name);
+#endif
+    return master;
+}
+
+/**
+ * @brief Pins the calling thread to a single CPU core
+ *
+ * @param cpu The index of the CPU core to pin the thread to
+ * @return `0` or `-1` in case of an error (`ENOTSUP` on platforms without thread affinity)
+ */
+int32_t thread_set_affinity(int64_t cpu) {
+#ifdef __linux__
+    // Restrict the thread's CPU set to the single core
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)cpu, &set);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+#else
+    (void)cpu;
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Elevates the calling thread to the `SCHED_FIFO` realtime scheduling class
+ *
+ * @param priority The realtime priority to schedule the thread with
+ * @return `0` or `-1` in case of an error (usually `EPERM` without the required privileges)
+ */
+int32_t thread_set_realtime(int32_t priority) {
+    // Switch the thread to the realtime scheduling class
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = (int)priority;
+    int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+/// Whether a config reload has been requested via `SIGHUP`
+static volatile sig_atomic_t reload_flag = 0;
+
+/**
+ * @brief The `SIGHUP` handler that requests a config reload
+ */
+static void reload_handler(int sig) {
+    (void)sig;
+    reload_flag = 1;
+}
+
+/**
+ * @brief Installs the `SIGHUP` handler that requests a config reload
+ *
+ * The signal is masked in the calling thread, so a process-directed `SIGHUP` is delivered to one of the runloop
+ * threads (which unmask it via `reload_unmask`) and interrupts its blocking syscall
+ *
+ * @return `0` or `-1` in case of an error
+ */
+int32_t reload_init(void) {
+    // Install the handler without `SA_RESTART` so blocking syscalls return with `EINTR`
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = reload_handler;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGHUP, &action, NULL) < 0) {
+        return -1;
+    }
+
+    // Mask the signal in the calling thread
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    int error = pthread_sigmask(SIG_BLOCK, &set, NULL);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Unmasks `SIGHUP` in the calling runloop thread so it can be interrupted for a config reload
+ *
+ * @return `0` or `-1` in case of an error
+ */
+int32_t reload_unmask(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    int error = pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Whether a config reload has been requested
+ *
+ * @return `1` if a reload is pending, `0` otherwise
+ */
+int32_t reload_pending(void) {
+    return reload_flag != 0;
+}
+
+/**
+ * @brief Clears a pending config reload request
+ */
+void reload_clear(void) {
+    reload_flag = 0;
+}
+
+/**
+ * @brief The opaque identifier of the calling thread
+ *
+ * @return The thread identifier
+ */
+uint64_t thread_current(void) {
+    return (uint64_t)pthread_self();
+}
+
+/**
+ * @brief Interrupts the thread behind `thread` with `SIGHUP` so its blocking syscall returns
+ *
+ * @param thread The identifier of the thread to interrupt
+ * @return `0` or `-1` in case of an error
+ */
+int32_t thread_interrupt(uint64_t thread) {
+    int error = pthread_kill((pthread_t)thread, SIGHUP);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Memory-maps `len` bytes of the file behind `fd` as a shared, writable mapping
+ *
+ * @param fd The file descriptor of the backing file
+ * @param len The length of the mapping in bytes
+ * @return The mapped base address or `NULL` in case of an error
+ */
+void* capture_map(int64_t fd, uint64_t len) {
+    // Map the file so writes land in the page cache without any syscall on the hot path
+    void* map = mmap(NULL, (size_t)len, PROT_READ | PROT_WRITE, MAP_SHARED, (int)fd, 0);
+    return map == MAP_FAILED ? NULL : map;
+}
+
+/**
+ * @brief Unmaps a mapping created by `capture_map`
+ *
+ * @param map The mapped base address
+ * @param len The length of the mapping in bytes
+ */
+void capture_unmap(void* map, uint64_t len) {
+    munmap(map, (size_t)len);
+}
+
 /**
  * @brief Duplicates `fd`
- * 
+ *
  * @param fd The file descriptor to duplicate
  * @return The duplicate file descriptor or `-1` in case of an error
  */
@@ -89,46 +455,110 @@ int64_t serial_duplicate(int64_t fd) {
 }
 
 /**
- * @brief Reads one byte from `fd`
- * 
- * @param fd The file descriptor to write to
+ * @brief Reads up to `len` bytes from `fd`
+ *
+ * @param fd The file descriptor to read from
  * @param buf The target buffer
- * @return `0` or `-1` on error
+ * @param len The target buffer size
+ * @return The amount of bytes read or `-1` in case of an error
+ *
+ * @note Due to the `VMIN = 1, VTIME = 0` setup in `serial_open`, this call blocks until at least one byte is available
+ *       and then drains whatever the kernel has buffered in a single syscall
  */
-int32_t serial_read_one(int64_t fd, uint8_t* buf) {
-    // Try to read a single byte
-    ssize_t read_ = read(fd, buf, 1);
+int64_t serial_read(int64_t fd, uint8_t* buf, uint64_t len) {
+    // Read as many bytes as available
+    ssize_t read_ = read(fd, buf, (size_t)len);
     if (read_ == 0) {
         errno = EOF;
     }
     if (read_ < 1) {
         return -1;
     }
+    return (int64_t)read_;
+}
+
+/**
+ * @brief Enables or disables nonblocking mode on `fd`
+ *
+ * @param fd The file descriptor to configure
+ * @param enable Whether to enable or disable nonblocking mode
+ * @return `0` or `-1` in case of an error
+ */
+int32_t serial_set_nonblocking(int64_t fd, int32_t enable) {
+    // Update the nonblocking flag
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) {
+        return -1;
+    }
+    flags = enable != 0 ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+    if (fcntl(fd, F_SETFL, flags) != 0) {
+        return -1;
+    }
     return 0;
 }
 
 /**
- * @brief Writes one byte to `fd`
- * 
+ * @brief Waits until `fd` becomes writable or the timeout expires
+ *
+ * @param fd The file descriptor to wait for
+ * @param timeout_ms The maximum time to wait in milliseconds
+ * @return `1` if the descriptor is writable, `0` on timeout or `-1` in case of an error
+ */
+int32_t serial_poll_writable(int64_t fd, int32_t timeout_ms) {
+    // Poll the descriptor for writability
+    struct pollfd pollfd = { .fd = (int)fd, .events = POLLOUT, .revents = 0 };
+    int ready = poll(&pollfd, 1, timeout_ms);
+    if (ready < 0) {
+        return -1;
+    }
+    return ready > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Waits until `fd` becomes readable or the timeout expires
+ *
+ * @param fd The file descriptor to wait for
+ * @param timeout_ms The maximum time to wait in milliseconds
+ * @return `1` if the descriptor is readable, `0` on timeout or `-1` in case of an error
+ */
+int32_t serial_poll(int64_t fd, int32_t timeout_ms) {
+    // Poll the descriptor for readability
+    struct pollfd pollfd = { .fd = (int)fd, .events = POLLIN, .revents = 0 };
+    int ready = poll(&pollfd, 1, timeout_ms);
+    if (ready < 0) {
+        return -1;
+    }
+    return ready > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Writes up to `len` bytes to `fd`
+ *
  * @param fd The file descriptor to write to
- * @param byte The byte to write
- * @return `0` or `-1` on error
+ * @param buf The bytes to write
+ * @param len The amount of bytes to write
+ * @return The amount of bytes written or `-1` in case of an error
  */
-int32_t serial_write_one(int64_t fd, const uint8_t* byte) {
-    // Write a single byte
-    ssize_t written = write(fd, byte, 1);
+int64_t serial_write(int64_t fd, const uint8_t* buf, uint64_t len) {
+    // Write as many bytes as possible
+    ssize_t written = write(fd, buf, (size_t)len);
     if (written == 0) {
         errno = EOF;
     }
     if (written < 1) {
         return -1;
     }
+    return (int64_t)written;
+}
 
-    // Flush output
-    if (fsync(fd) != 0) {
-        return -1;
-    }
-    return 0;
+/**
+ * @brief Blocks until all pending output has been transmitted to the device
+ *
+ * @param fd The file descriptor to drain
+ * @return `0` or `-1` in case of an error
+ */
+int32_t serial_drain(int64_t fd) {
+    return tcdrain(fd);
 }
 
 /**
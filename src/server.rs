@@ -1,104 +1,1199 @@
 //! A unified server
 
-use crate::{config::Config, error::Error, logger::Logger, serial::SerialDevice};
+use crate::{
+    capture::{Direction, Recorder},
+    config::{self, Config, Engine},
+    error::Error,
+    framing::Framer,
+    logger::Logger,
+    lz4,
+    net::{self, Batch, Transport},
+    pool::{Lease, Pool},
+    queue::Queue,
+    reload, sched,
+    serial::SerialDevice,
+    spsc::Ring,
+    stats::Stats,
+    subscribers::Registry,
+    tcp::Fanout,
+    uring::{Completion, Uring},
+};
 use std::{
+    fmt, fs,
     io::{self, Read, Write},
-    net::{ToSocketAddrs, UdpSocket},
+    net::{SocketAddr, TcpListener, ToSocketAddrs, UdpSocket},
+    os::{fd::AsRawFd, unix::net::UnixDatagram},
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc, Mutex,
+    },
     thread,
+    time::{Duration, Instant},
 };
 
+/// The interval at which indefinitely blocking runloop waits re-check for a pending config reload
+const RELOAD_CHECK: Duration = Duration::from_millis(250);
+/// The initial backoff between reopen attempts of the serial watchdog
+const WATCHDOG_BACKOFF_MIN: Duration = Duration::from_millis(10);
+/// The maximum backoff between reopen attempts of the serial watchdog
+const WATCHDOG_BACKOFF_MAX: Duration = Duration::from_secs(1);
+
+/// The bridge's shared serial device together with its reopen generation
+///
+/// The watchdog publishes a reopened device back into the slot, so the sibling runloop threads and the reload
+/// retention always see the live descriptor. The generation lets a thread that still holds a dead clone detect that
+/// the device has already been reopened and adopt it instead of opening a second descriptor onto the same path
+struct SerialSlot {
+    /// The serial device
+    serial: SerialDevice,
+    /// The reopen generation, bumped whenever the watchdog publishes a reopened device
+    generation: u64,
+}
+
+/// A single serial<->UDP bridge
+struct Bridge {
+    /// The bridge config
+    config: config::Bridge,
+    /// The listening datagram socket
+    socket: Transport,
+    /// The serial device slot shared between the runloop threads and the watchdog
+    serial: Mutex<SerialSlot>,
+    /// The registry of dynamic subscribers, if subscriber mode is enabled
+    subscribers: Option<Registry>,
+    /// The TCP fan-out, if the transport is TCP
+    tcp: Option<Arc<Fanout>>,
+}
+impl Bridge {
+    /// Creates a new bridge, reusing the already open `retained` serial device instead of reopening the path
+    fn new(config: config::Bridge, retained: Option<SerialDevice>) -> Result<Self, Error> {
+        // Validate the framing parameters
+        config.serial.framing.validate()?;
+
+        // Bind the configured transport and setup the serial device
+        let socket = match config.udp.transport {
+            config::Transport::Udp => {
+                let socket = UdpSocket::bind(&config.udp.listen)?;
+                socket.set_ttl(config.udp.ttl)?;
+                Transport::Udp(socket)
+            }
+            config::Transport::Unix => {
+                // Remove a stale socket file from a previous run before binding
+                let _ = fs::remove_file(&config.udp.listen);
+                Transport::Unix(UnixDatagram::bind(&config.udp.listen)?)
+            }
+            config::Transport::Tcp => Transport::Tcp(TcpListener::bind(&config.udp.listen)?),
+        };
+        net::set_buffers(&socket, config.udp.rcvbuf, config.udp.sndbuf)?;
+        if config.udp.busy_poll_us > 0 {
+            net::set_busy_poll(&socket, config.udp.busy_poll_us)?;
+        }
+        let rtscts = config.serial.flow_control == config::FlowControl::Rtscts;
+        let serial = match retained {
+            // Reuse the open descriptor so the adapter never sees a close/reopen cycle (which toggles DTR on many
+            // adapters); normalize it back to blocking mode for the threads engine
+            Some(serial) => {
+                serial.set_nonblocking(false)?;
+                serial
+            }
+            None => SerialDevice::new(&config.serial.device, config.serial.baudrate, rtscts, config.serial.drain)?,
+        };
+
+        // Apply the configured read thresholds; adaptive mode starts with the idle thresholds
+        if config.serial.vmin == 0 && config.serial.vtime == 0 {
+            return Err(eio!("The serial read thresholds vmin = 0 and vtime = 0 would turn reads into busy-polling"));
+        }
+        match config.serial.adaptive {
+            true => serial.tune(1, 0)?,
+            false => serial.tune(config.serial.vmin, config.serial.vtime)?,
+        }
+
+        // Apply the driver-level low-latency tuning if configured
+        if config.serial.low_latency {
+            serial.low_latency(&config.serial.device)?;
+        }
+
+        // Setup the subscriber registry and the TCP fan-out if enabled
+        let ttl = Duration::from_secs(config.udp.subscriber_ttl_secs);
+        let subscribers = (config.udp.subscribers > 0).then(|| Registry::new(config.udp.subscribers, ttl));
+        let tcp = (config.udp.transport == config::Transport::Tcp)
+            .then(|| Arc::new(Fanout::new(config.udp.nodelay, config.udp.client_queue)));
+        let serial = Mutex::new(SerialSlot { serial, generation: 0 });
+        Ok(Self { config, socket, serial, subscribers, tcp })
+    }
+
+    /// Clones the bridge's current serial device together with its reopen generation
+    fn serial(&self) -> io::Result<(SerialDevice, u64)> {
+        let slot = self.serial.lock().expect("Serial slot mutex is poisoned");
+        Ok((slot.serial.try_clone()?, slot.generation))
+    }
+
+    /// Adopts the bridge's serial device if the watchdog has published a newer generation than the caller's
+    fn adopt_serial(&self, generation: &mut u64) -> Option<SerialDevice> {
+        let slot = self.serial.lock().expect("Serial slot mutex is poisoned");
+        if slot.generation == *generation {
+            return None;
+        }
+        let adopted = slot.serial.try_clone().ok()?;
+        *generation = slot.generation;
+        Some(adopted)
+    }
+
+    /// Publishes a reopened serial device into the bridge's slot and returns the caller's clone of it
+    ///
+    /// If another thread has published a newer generation in the meantime, its device is adopted instead and the
+    /// passed device is dropped, so concurrent reopens never fight over the slot. Returns `None` if cloning fails
+    fn publish_serial(&self, serial: SerialDevice, generation: &mut u64) -> Option<SerialDevice> {
+        let mut slot = self.serial.lock().expect("Serial slot mutex is poisoned");
+        if slot.generation != *generation {
+            let adopted = slot.serial.try_clone().ok()?;
+            *generation = slot.generation;
+            return Some(adopted);
+        }
+        let published = serial.try_clone().ok()?;
+        slot.serial = serial;
+        slot.generation = slot.generation.wrapping_add(1);
+        *generation = slot.generation;
+        Some(published)
+    }
+
+    /// Tracks the peers of the received batch as dynamic subscribers
+    fn track_peers(&self, batch: &Batch, received: usize) {
+        // Register each known peer of the batch
+        if let Some(registry) = self.subscribers.as_ref() {
+            for index in 0..received {
+                if let Some(peer) = batch.peer(index) {
+                    registry.insert(peer);
+                }
+            }
+        }
+    }
+}
+
+/// The destination of a send target's unconnected fallback path
+enum TargetAddress {
+    /// A UDP destination address
+    Udp(SocketAddr),
+    /// A Unix-domain socket path
+    Unix(String),
+}
+
+/// An outgoing datagram destination with its dedicated socket
+struct SendTarget {
+    /// The destination address
+    address: TargetAddress,
+    /// The socket for outgoing packets
+    socket: Transport,
+    /// Whether the socket is connected to the destination
+    connected: bool,
+}
+impl SendTarget {
+    /// Creates a new UDP send target for the given address
+    fn new_udp(address: SocketAddr, ttl: u32, sndbuf: usize) -> Result<Self, Error> {
+        // Connect the socket so per-packet sends skip the kernel's destination handling and route lookup
+        let socket = UdpSocket::bind("0.0.0.0:0")?;
+        socket.set_ttl(ttl)?;
+        net::set_buffers(&socket, 0, sndbuf)?;
+        let connected = socket.connect(address).is_ok();
+        Ok(Self { address: TargetAddress::Udp(address), socket: Transport::Udp(socket), connected })
+    }
+
+    /// Creates a new Unix-domain send target for the given socket path
+    fn new_unix(path: &str, sndbuf: usize) -> Result<Self, Error> {
+        // Connect the socket so sends can use the batched fast path; if the consumer is not up yet, fall back to
+        // per-packet destinations until it is
+        let socket = UnixDatagram::unbound()?;
+        net::set_buffers(&socket, 0, sndbuf)?;
+        let connected = socket.connect(path).is_ok();
+        Ok(Self { address: TargetAddress::Unix(path.to_string()), socket: Transport::Unix(socket), connected })
+    }
+
+    /// Sends a single packet to the destination
+    fn send(&self, buf: &[u8]) -> io::Result<()> {
+        // Send the packet over the connected socket, falling back to a per-packet destination
+        match (self.connected, &self.address) {
+            (true, _) => _ = self.socket.send(buf)?,
+            (false, TargetAddress::Udp(address)) => _ = self.socket.send_to(buf, address)?,
+            (false, TargetAddress::Unix(path)) => _ = self.socket.send_to_path(buf, path)?,
+        }
+        Ok(())
+    }
+}
+
+/// The serial->UDP pipeline that frames, coalesces and sends serial data
+struct SerialPipeline<'a> {
+    /// The server
+    server: &'a Server,
+    /// The bridge the pipeline belongs to
+    bridge: &'a Bridge,
+    /// The outgoing destinations, each with its own connected socket
+    targets: Vec<SendTarget>,
+    /// The scratch list of currently live dynamic subscribers
+    subscribers: Vec<SocketAddr>,
+    /// The batch for outgoing packets, shared by all connected targets
+    batch: Batch,
+    /// The framing engine
+    framer: Framer,
+    /// The maximum time frames may be delayed to coalesce them into larger packets
+    coalesce: Duration,
+    /// The maximum payload size
+    mtu: usize,
+    /// The LZ4 compressor, if compression is enabled
+    compressor: Option<lz4::Compressor>,
+    /// The minimum payload size for compression
+    compress_min: usize,
+    /// The scratch buffer for compressed payloads
+    scratch: Lease,
+    /// The pending packet
+    packet: Lease,
+    /// The flush deadline of the pending packet
+    deadline: Instant,
+    /// The time the last serial data has been pushed into the pipeline
+    last_data: Instant,
+}
+impl<'a> SerialPipeline<'a> {
+    /// Creates a new serial->UDP pipeline
+    fn new(server: &'a Server, bridge: &'a Bridge) -> Result<Self, Error> {
+        // Resolve the destinations and create one send target per address
+        let mut targets = Vec::new();
+        for address in &bridge.config.udp.send {
+            let target = match bridge.config.udp.transport {
+                config::Transport::Udp => {
+                    let address = (address.to_socket_addrs()?.next())
+                        .ok_or_else(|| eio!("Cannot resolve send address: {address}"))?;
+                    SendTarget::new_udp(address, bridge.config.udp.ttl, bridge.config.udp.sndbuf)?
+                }
+                config::Transport::Unix => SendTarget::new_unix(address, bridge.config.udp.sndbuf)?,
+                // TCP clients connect to the listener and are serviced by the fan-out instead of send targets
+                config::Transport::Tcp => continue,
+            };
+            targets.push(target);
+        }
+
+        // Create the pipeline
+        let batch = Batch::new(bridge.config.udp.batch, bridge.config.udp.mtu);
+        let framer = Framer::new(bridge.config.serial.framing.clone());
+        let coalesce = Duration::from_micros(bridge.config.udp.coalesce_us);
+        let mtu = bridge.config.udp.mtu;
+        let compress_min = bridge.config.udp.compress_min;
+        let compressor = (compress_min > 0).then(lz4::Compressor::new);
+        let (scratch, packet) = (server.pool.lease(), server.pool.lease());
+        let (deadline, last_data) = (Instant::now(), Instant::now());
+        let subscribers = Vec::new();
+        Ok(Self {
+            server,
+            bridge,
+            targets,
+            subscribers,
+            batch,
+            framer,
+            coalesce,
+            mtu,
+            compressor,
+            compress_min,
+            scratch,
+            packet,
+            deadline,
+            last_data,
+        })
+    }
+
+    /// The maximum time the pipeline may wait for more serial data before a pending timer expires
+    fn timeout(&self) -> Option<Duration> {
+        // Never wait past the flush deadline of the pending packet
+        let mut timeout = None;
+        if !self.packet.is_empty() {
+            timeout = Some(self.deadline.saturating_duration_since(Instant::now()));
+        }
+
+        // Never wait past the inter-byte timeout of a partial frame
+        if let Some(gap) = self.framer.timeout().filter(|_| self.framer.has_partial()) {
+            let remaining = (self.last_data + gap).saturating_duration_since(Instant::now());
+            timeout = Some(timeout.map_or(remaining, |timeout: Duration| timeout.min(remaining)));
+        }
+        timeout
+    }
+
+    /// Feeds a chunk of serial data into the pipeline
+    fn push(&mut self, chunk: &[u8]) {
+        self.framer.push(chunk);
+        self.last_data = Instant::now();
+    }
+
+    /// Processes expired timers and completed frames and sends the resulting packets
+    ///
+    /// Send failures are transient by design: an absent consumer answers with ICMP port-unreachable, which surfaces
+    /// as `ECONNREFUSED` on the next send over the connected socket - such failures are counted via the send-error
+    /// stat and the pipeline keeps pumping, so one dead target cannot tear the bridge down or starve the live ones
+    fn pump(&mut self) {
+        // Complete a partial frame if the inter-byte timeout has expired
+        if let Some(gap) = self.framer.timeout().filter(|_| self.framer.has_partial()) {
+            if Instant::now() >= self.last_data + gap {
+                self.framer.flush();
+            }
+        }
+
+        // Refresh the live dynamic subscribers once per pump
+        if let Some(registry) = self.bridge.subscribers.as_ref() {
+            registry.collect(&mut self.subscribers);
+        }
+
+        // The send implementation: batched sends are queued once and fanned out to all connected targets on flush
+        let (targets, subscribers, listener) = (&self.targets, &self.subscribers, &self.bridge.socket);
+        let (stats, last_data) = (&self.server.stats, self.last_data);
+        let (tcp, pool) = (self.bridge.tcp.as_deref(), &self.server.pool);
+        let batched = self.bridge.config.udp.batch > 1;
+        let send_packet = |batch: &mut Batch, buf: &[u8]| {
+            // Send directly to the targets that cannot use batched I/O
+            for target in targets.iter().filter(|target| !batched || !target.connected) {
+                if target.send(buf).is_err() {
+                    stats.send_error();
+                }
+            }
+
+            // Reply to the dynamic subscribers from the listen socket, so they see the port they sent to
+            for subscriber in subscribers {
+                if listener.send_to(buf, subscriber).is_err() {
+                    stats.send_error();
+                }
+            }
+
+            // Queue the payload for every connected TCP client
+            if let Some(fanout) = tcp {
+                fanout.broadcast(pool, buf);
+            }
+
+            // Queue the payload once for all batched targets; flush the batch if it is full and send oversized
+            // payloads directly. A failed flush drops the pending datagrams, so the batch cannot wedge behind a
+            // dead target
+            if batched && targets.iter().any(|target| target.connected) {
+                if !batch.push(buf) {
+                    let connected = targets.iter().filter(|target| target.connected);
+                    if batch.send_all(connected.map(|target| &target.socket)).is_err() {
+                        stats.send_error();
+                        batch.clear();
+                    }
+                    if !batch.push(buf) {
+                        for target in targets.iter().filter(|target| target.connected) {
+                            if target.send(buf).is_err() {
+                                stats.send_error();
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Record the produced packet and its serial-read->udp-send latency
+            stats.udp_sent(buf.len());
+            stats.latency(last_data.elapsed());
+        };
+
+        // Coalesce the completed frames into the pending packet
+        let (compressor, scratch, compress_min) = (&mut self.compressor, &mut self.scratch, self.compress_min);
+        while let Some(frame) = self.framer.next_frame() {
+            // Flush early if the frame would overflow the pending packet
+            if !self.packet.is_empty() && self.packet.len() + frame.len() > self.mtu {
+                let payload = Self::compress(compressor, scratch, &self.packet, compress_min);
+                send_packet(&mut self.batch, payload);
+                self.server.log(&self.packet);
+                self.packet.clear();
+            }
+
+            // Append the frame and start the flush deadline with the first frame of a packet
+            if self.packet.is_empty() {
+                self.deadline = Instant::now() + self.coalesce;
+            }
+            self.packet.extend_from_slice(frame);
+        }
+
+        // Flush the packet if coalescing is disabled, the packet is MTU-sized, or the deadline has expired
+        if !self.packet.is_empty()
+            && (self.coalesce.is_zero() || self.packet.len() >= self.mtu || Instant::now() >= self.deadline)
+        {
+            let payload = Self::compress(compressor, scratch, &self.packet, compress_min);
+            send_packet(&mut self.batch, payload);
+            self.server.log(&self.packet);
+            self.packet.clear();
+        }
+
+        // Flush any batched packets before going back to waiting, dropping them if the flush fails
+        let connected = self.targets.iter().filter(|target| target.connected);
+        if self.batch.send_all(connected.map(|target| &target.socket)).is_err() {
+            self.server.stats.send_error();
+            self.batch.clear();
+        }
+    }
+
+    /// Compresses the payload into the magic-prefixed scratch frame if compression is enabled and pays off
+    fn compress<'b>(
+        compressor: &mut Option<lz4::Compressor>,
+        scratch: &'b mut Lease,
+        payload: &'b [u8],
+        threshold: usize,
+    ) -> &'b [u8] {
+        // Skip payloads without a compressor, oversized payloads and payloads below the threshold – unless a raw
+        // payload starts with the magic, which must be compressed to stay distinguishable from a compressed one
+        let Some(compressor) = compressor.as_mut() else { return payload };
+        let forced = payload.starts_with(&lz4::MAGIC);
+        if payload.len() > u16::MAX as usize || (payload.len() < threshold && !forced) {
+            return payload;
+        }
+
+        // Compress into the magic-prefixed scratch frame, keeping the raw payload if compression does not pay off
+        scratch.clear();
+        scratch.extend_from_slice(&lz4::MAGIC);
+        scratch.extend_from_slice(&(payload.len() as u16).to_le_bytes());
+        compressor.compress(payload, scratch);
+        match scratch.len() < payload.len() || forced {
+            true => scratch,
+            false => payload,
+        }
+    }
+}
+
 /// The server
 pub struct Server {
     /// The server config
     config: Config,
-    /// The UDP socket
-    socket: UdpSocket,
-    /// The serial device
-    serial: SerialDevice,
+    /// The serial<->UDP bridges
+    bridges: Vec<Bridge>,
+    /// The buffer pool shared by all bridges
+    pool: Pool,
     /// The logger
     logger: Option<Logger>,
+    /// The flight recorder, if capture is enabled
+    capture: Option<Recorder>,
+    /// The hot-path instrumentation
+    stats: Stats,
 }
 impl Server {
     /// Creates a new server
     pub fn new(config: Config) -> Result<Self, Error> {
-        // Setup socket
-        let socket = UdpSocket::bind(&config.udp.listen)?;
-        socket.set_ttl(config.udp.ttl)?;
+        Self::with_serials(config, Vec::new())
+    }
+
+    /// Creates a new server, reusing the given open serial devices for bridges whose `[serial]` section is unchanged
+    pub fn with_serials(config: Config, mut serials: Vec<(config::Serial, SerialDevice)>) -> Result<Self, Error> {
+        // Create all configured bridges, handing matching retained serial devices through
+        let bridges: Vec<Bridge> = (config.bridges()?.into_iter())
+            .map(|bridge| {
+                let retained = (serials.iter().position(|(serial, _)| *serial == bridge.serial))
+                    .map(|index| serials.swap_remove(index).1);
+                Bridge::new(bridge, retained)
+            })
+            .collect::<Result<_, _>>()?;
 
-        // Setup spipe and logger
-        let serial = SerialDevice::new(&config.serial.device, config.serial.baudrate)?;
-        let logger = config.log.enabled.then(Logger::new);
-        Ok(Self { config, socket, serial, logger })
+        // Setup the shared buffer pool and logger; a zero pool size derives the buffer capacity from the fastest
+        // configured baudrate (a UART moves about `baudrate / 10` bytes per second, and one buffer should absorb
+        // roughly 100ms of line-rate traffic)
+        let size = match config.pool.size {
+            0 => {
+                let bauds = (bridges.iter()).map(|bridge| bridge.config.serial.baudrate).max().unwrap_or(0);
+                ((bauds / 100) as usize).next_power_of_two().clamp(4096, 65536)
+            }
+            size => size,
+        };
+        let pool = Pool::new(config.pool.count, size);
+        let logger = config.log.enabled.then(|| Logger::new(pool.clone()));
+        let capture =
+            (config.capture.file.as_deref()).map(|path| Recorder::new(path, config.capture.size)).transpose()?;
+        let stats = Stats::default();
+        Ok(Self { config, bridges, pool, logger, capture, stats })
+    }
+
+    /// The server's instrumentation handle
+    pub fn stats(&self) -> Stats {
+        self.stats.clone()
+    }
+
+    /// Extracts the open serial devices with their configs (e.g. to hand them to the next server after a reload)
+    pub fn into_serials(self) -> Vec<(config::Serial, SerialDevice)> {
+        (self.bridges.into_iter())
+            .map(|bridge| {
+                let slot = bridge.serial.into_inner().expect("Serial slot mutex is poisoned");
+                (bridge.config.serial, slot.serial)
+            })
+            .collect()
     }
 
     /// Starts the server runloop
-    pub fn runloop(self) -> Result<(), Error> {
+    ///
+    /// The runloop returns `Ok` once a config reload has been requested via `SIGHUP` and all runloop threads have
+    /// exited cleanly; the caller can then rebuild the server from the re-read config
+    pub fn runloop(&self) -> Result<(), Error> {
+        /// The generation of the current server run, so stats threads of previous runs exit after a reload
+        static GENERATION: AtomicU64 = AtomicU64::new(0);
+        let generation = GENERATION.fetch_add(1, Ordering::Relaxed) + 1;
+
+        // Periodically dump the stats if instrumentation is compiled in and configured
+        let interval = Duration::from_secs(self.config.stats.interval_secs);
+        if cfg!(feature = "stats") && !interval.is_zero() {
+            let (stats, logger) = (self.stats.clone(), self.logger.clone());
+            thread::spawn(move || loop {
+                // Dump a one-line summary through the logger, falling back to stderr
+                thread::sleep(interval);
+                if GENERATION.load(Ordering::Relaxed) != generation {
+                    return;
+                }
+                let line = stats.format();
+                match logger.as_ref() {
+                    Some(logger) => logger.log(format!("{line}\n")),
+                    None => eprintln!("{line}"),
+                }
+            });
+        }
+
+        match self.config.engine {
+            Engine::Threads => self.runloop_threads(),
+            Engine::EventLoop => self.runloop_eventloop(),
+            Engine::IoUring => self.runloop_uring(),
+            Engine::BusyPoll => self.runloop_busypoll(),
+        }
+    }
+
+    /// The threaded runloop with a serial drain thread, a UDP send thread, a UDP receive thread and a serial write
+    /// thread per bridge
+    fn runloop_threads(&self) -> Result<(), Error> {
+        // Create one drain->send handoff ring and one bounded recv->write queue per bridge
+        let rings: Vec<Ring<Lease>> = self.bridges.iter().map(|bridge| Ring::new(bridge.config.udp.queue)).collect();
+        let write_queues: Vec<Queue<Lease>> = (self.bridges.iter())
+            .map(|bridge| Queue::new(bridge.config.udp.write_queue, bridge.config.udp.write_policy))
+            .collect();
+
         thread::scope(|scope| -> Result<(), Error> {
-            // Clone serial port and spawn threads
-            let (serial_in, serial_out) = (self.serial.try_clone()?, self.serial.try_clone()?);
-            let serial2udp = scope.spawn(|| self.runloop_serial2udp(serial_in));
-            let udp2serial = scope.spawn(|| self.runloop_udp2serial(serial_out));
+            // Spawn the per-bridge threads
+            let mut threads = Vec::new();
+            for ((bridge, ring), write_queue) in self.bridges.iter().zip(&rings).zip(&write_queues) {
+                let (serial_in, generation_in) = bridge.serial()?;
+                let (serial_out, generation_out) = bridge.serial()?;
+                threads.push(scope.spawn(move || self.runloop_serial_drain(bridge, serial_in, generation_in, ring)));
+                threads.push(scope.spawn(move || self.runloop_udp_send(bridge, ring)));
+                match bridge.tcp.clone() {
+                    // TCP clients are serviced by the fan-out's acceptor and per-client threads
+                    Some(fanout) => {
+                        let listener = match &bridge.socket {
+                            Transport::Tcp(listener) => listener.try_clone()?,
+                            _ => return Err(eio!("The TCP fan-out requires a TCP listener")),
+                        };
+                        let stats = self.stats.clone();
+                        threads.push(scope.spawn(move || fanout.runloop_acceptor(listener, serial_out, stats)));
+                    }
+                    // Datagram transports use the bounded recv->write queue
+                    None => {
+                        threads.push(scope.spawn(move || self.runloop_udp_recv(bridge, write_queue)));
+                        threads.push(
+                            scope.spawn(move || {
+                                self.runloop_serial_write(bridge, serial_out, generation_out, write_queue)
+                            }),
+                        );
+                    }
+                }
+            }
 
             // Wait for threads and propagate results
-            serial2udp.join().expect("Serial->UDP thread has panicked")?;
-            udp2serial.join().expect("UDP->serial thread has panicked")?;
+            for thread in threads {
+                thread.join().expect("Bridge thread has panicked")?;
+            }
             Ok(())
         })
     }
-    /// The serial->UDP runloop
-    fn runloop_serial2udp(&self, mut serial: SerialDevice) -> Result<(), Error> {
-        // Unwrap and resolve the remote address
-        let address = (self.config.udp.send.as_ref())
-            .map(|address| address.to_socket_addrs())
-            .transpose()?
-            .and_then(|mut addresses| addresses.next());
 
-        // The `socket::send_to` implementation *if there is a remote address configured*
-        let socket_send_to = {
-            // Create the socket
-            let socket = UdpSocket::bind("0.0.0.0:0")?;
-            socket.set_ttl(self.config.udp.ttl)?;
+    /// The single-threaded event-loop runloop that services all bridges over nonblocking descriptors
+    fn runloop_eventloop(&self) -> Result<(), Error> {
+        // The TCP fan-out needs dedicated per-client threads
+        if self.bridges.iter().any(|bridge| bridge.tcp.is_some()) {
+            return Err(eio!("The TCP transport requires the threads engine"));
+        }
+
+        // The single loop thread services both directions, so pin it to the serial->UDP core
+        self.apply_sched(self.config.sched.serial2udp_cpu)?;
+        reload::register()?;
+
+        // Switch all descriptors to nonblocking mode and collect the per-bridge state
+        let mut fds = Vec::new();
+        let mut serials = Vec::new();
+        let mut generations = Vec::new();
+        let mut pipelines = Vec::new();
+        let mut batches = Vec::new();
+        for bridge in &self.bridges {
+            let (serial, generation) = bridge.serial()?;
+            serial.set_nonblocking(true)?;
+            bridge.socket.set_nonblocking(true)?;
+            fds.push(serial.as_raw_fd());
+            fds.push(bridge.socket.as_raw_fd());
+            serials.push(serial);
+            generations.push(generation);
+            pipelines.push(SerialPipeline::new(self, bridge)?);
+            batches.push(Batch::new(bridge.config.udp.batch, self.pool.size()));
+        }
+
+        // Ensure the descriptors fit into the poll bitmask
+        if fds.len() > 32 {
+            return Err(eio!("The event-loop engine supports at most 16 bridges"));
+        }
+
+        // Service all bridges from one thread
+        let mut buf = self.pool.lease_zeroed();
+        loop {
+            // Exit cleanly once a config reload has been requested
+            if reload::pending() {
+                return Ok(());
+            }
 
-            // Create the closure
-            move |buf: &[u8]| -> io::Result<usize> {
-                // Send UDP packet if a multicast address is defined or perform a no-op
-                match address.as_ref() {
-                    Some(multicast) => socket.send_to(buf, multicast),
-                    None => Ok(buf.len()),
+            // Wait until a descriptor becomes readable, the earliest pipeline timer expires or the reload check is due
+            let timeout = Self::earliest_timeout(&pipelines).unwrap_or(RELOAD_CHECK).min(RELOAD_CHECK);
+            let readable = match net::poll_readable(&fds, Some(timeout)) {
+                Ok(readable) => readable,
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+                Err(error) => return Err(error.into()),
+            };
+
+            // Service the readable descriptors of each bridge
+            for (index, bridge) in self.bridges.iter().enumerate() {
+                // Drain the serial device into the pipeline
+                if readable & (1 << (index * 2)) != 0 {
+                    match serials[index].read(&mut buf) {
+                        Ok(bytes_read) => {
+                            self.stats.serial_read(bytes_read);
+                            self.capture(Direction::Serial2Udp, &buf[..bytes_read]);
+                            pipelines[index].push(&buf[..bytes_read]);
+                        }
+                        Err(error) if error.kind() == io::ErrorKind::WouldBlock => (),
+                        Err(error) if error.kind() == io::ErrorKind::Interrupted => (),
+                        // Let the watchdog reopen a re-enumerated device instead of tearing the loop down
+                        Err(error) => match self.reopen_serial(bridge, &mut generations[index], &error) {
+                            Some(reopened) => {
+                                reopened.set_nonblocking(true)?;
+                                fds[index * 2] = reopened.as_raw_fd();
+                                serials[index] = reopened;
+                            }
+                            None => return Ok(()),
+                        },
+                    }
+                }
+
+                // Drain the socket and write the datagrams to the serial device
+                if readable & (1 << (index * 2 + 1)) != 0 {
+                    match batches[index].recv(&bridge.socket) {
+                        Ok(received) => {
+                            self.stats.udp_truncated(batches[index].take_truncated());
+                            bridge.track_peers(&batches[index], received);
+                            for datagram in 0..received {
+                                let datagram = batches[index].datagram(datagram);
+                                self.stats.udp_received(datagram.len());
+                                if !datagram.is_empty() {
+                                    self.capture(Direction::Udp2Serial, datagram);
+                                    if let Err(error) = self.write_serial(&mut serials[index], datagram) {
+                                        // Reopen the device; the rest of the batch is lost with the device
+                                        match self.reopen_serial(bridge, &mut generations[index], &error) {
+                                            Some(reopened) => {
+                                                reopened.set_nonblocking(true)?;
+                                                fds[index * 2] = reopened.as_raw_fd();
+                                                serials[index] = reopened;
+                                            }
+                                            None => return Ok(()),
+                                        }
+                                        break;
+                                    }
+                                    self.log(datagram);
+                                }
+                            }
+                        }
+                        Err(error) if error.kind() == io::ErrorKind::WouldBlock => (),
+                        Err(error) => return Err(error.into()),
+                    }
                 }
             }
-        };
 
-        // Send the packets
-        let mut buf = vec![0; 400];
+            // Process timers and send pending packets
+            for pipeline in &mut pipelines {
+                pipeline.pump();
+            }
+        }
+    }
+
+    /// The single-threaded busy-polling runloop that spins over nonblocking descriptors for minimal wakeup latency
+    ///
+    /// The spin removes the blocking-read wakeup path and its scheduler latency from the hot path, trading a dedicated
+    /// core for consistent sub-100µs serial->UDP forwarding. After `spin_idle_us` without traffic the loop downgrades
+    /// to blocking waits, so an idle link does not burn the core; the first arriving data upgrades it back to spinning
+    fn runloop_busypoll(&self) -> Result<(), Error> {
+        // The TCP fan-out needs dedicated per-client threads
+        if self.bridges.iter().any(|bridge| bridge.tcp.is_some()) {
+            return Err(eio!("The TCP transport requires the threads engine"));
+        }
+
+        // The single loop thread services both directions, so pin it to the serial->UDP core
+        self.apply_sched(self.config.sched.serial2udp_cpu)?;
+        reload::register()?;
+
+        // Switch all descriptors to nonblocking mode and collect the per-bridge state
+        let mut fds = Vec::new();
+        let mut serials = Vec::new();
+        let mut generations = Vec::new();
+        let mut pipelines = Vec::new();
+        let mut batches = Vec::new();
+        for bridge in &self.bridges {
+            let (serial, generation) = bridge.serial()?;
+            serial.set_nonblocking(true)?;
+            bridge.socket.set_nonblocking(true)?;
+            fds.push(serial.as_raw_fd());
+            fds.push(bridge.socket.as_raw_fd());
+            serials.push(serial);
+            generations.push(generation);
+            pipelines.push(SerialPipeline::new(self, bridge)?);
+            batches.push(Batch::new(bridge.config.udp.batch, self.pool.size()));
+        }
+
+        // Ensure the descriptors fit into the poll bitmask of the idle-downgrade path
+        if fds.len() > 32 {
+            return Err(eio!("The busy-poll engine supports at most 16 bridges"));
+        }
+
+        // Spin over all bridges from one thread
+        let spin_idle = Duration::from_micros(self.config.sched.spin_idle_us);
+        let mut buf = self.pool.lease_zeroed();
+        let mut last_data = Instant::now();
         loop {
-            // Receive serial chunk
-            let bytes_read = serial.read(&mut buf)?;
-            if bytes_read > 0 {
-                // Send the message to the multicast address if a multicast
-                socket_send_to(&buf[..bytes_read])?;
-                self.log(&buf[..bytes_read]);
+            // Exit cleanly once a config reload has been requested
+            if reload::pending() {
+                return Ok(());
+            }
+
+            // Attempt a nonblocking sweep over every descriptor of each bridge
+            let mut active = false;
+            for (index, bridge) in self.bridges.iter().enumerate() {
+                // Drain the serial device into the pipeline
+                match serials[index].read(&mut buf) {
+                    Ok(bytes_read) => {
+                        self.stats.serial_read(bytes_read);
+                        self.capture(Direction::Serial2Udp, &buf[..bytes_read]);
+                        pipelines[index].push(&buf[..bytes_read]);
+                        active = true;
+                    }
+                    Err(error) if error.kind() == io::ErrorKind::WouldBlock => (),
+                    Err(error) if error.kind() == io::ErrorKind::Interrupted => (),
+                    // Let the watchdog reopen a re-enumerated device instead of tearing the loop down
+                    Err(error) => match self.reopen_serial(bridge, &mut generations[index], &error) {
+                        Some(reopened) => {
+                            reopened.set_nonblocking(true)?;
+                            fds[index * 2] = reopened.as_raw_fd();
+                            serials[index] = reopened;
+                        }
+                        None => return Ok(()),
+                    },
+                }
+
+                // Drain the socket and write the datagrams to the serial device
+                match batches[index].recv(&bridge.socket) {
+                    Ok(received) => {
+                        self.stats.udp_truncated(batches[index].take_truncated());
+                        bridge.track_peers(&batches[index], received);
+                        for datagram in 0..received {
+                            let datagram = batches[index].datagram(datagram);
+                            self.stats.udp_received(datagram.len());
+                            if !datagram.is_empty() {
+                                self.capture(Direction::Udp2Serial, datagram);
+                                if let Err(error) = self.write_serial(&mut serials[index], datagram) {
+                                    // Reopen the device; the rest of the batch is lost with the device
+                                    match self.reopen_serial(bridge, &mut generations[index], &error) {
+                                        Some(reopened) => {
+                                            reopened.set_nonblocking(true)?;
+                                            fds[index * 2] = reopened.as_raw_fd();
+                                            serials[index] = reopened;
+                                        }
+                                        None => return Ok(()),
+                                    }
+                                    break;
+                                }
+                                self.log(datagram);
+                            }
+                        }
+                        active = true;
+                    }
+                    Err(error) if error.kind() == io::ErrorKind::WouldBlock => (),
+                    Err(error) if error.kind() == io::ErrorKind::Interrupted => (),
+                    Err(error) => return Err(error.into()),
+                }
+            }
+
+            // Process timers and send pending packets
+            for pipeline in &mut pipelines {
+                pipeline.pump();
+            }
+
+            // Keep spinning while traffic flows; downgrade to a blocking wait after the quiet period
+            match active {
+                true => last_data = Instant::now(),
+                false if last_data.elapsed() < spin_idle => std::hint::spin_loop(),
+                false => {
+                    // Wait until a descriptor becomes readable, the earliest pipeline timer expires or the reload
+                    // check is due; the sweep after the wakeup picks the data up and resumes spinning
+                    let timeout = Self::earliest_timeout(&pipelines).unwrap_or(RELOAD_CHECK).min(RELOAD_CHECK);
+                    match net::poll_readable(&fds, Some(timeout)) {
+                        Ok(_) => (),
+                        Err(error) if error.kind() == io::ErrorKind::Interrupted => (),
+                        Err(error) => return Err(error.into()),
+                    }
+                }
             }
         }
     }
-    /// The UDP->serial runloop
-    fn runloop_udp2serial(&self, mut serial: SerialDevice) -> Result<(), Error> {
-        let mut buf = vec![0; 4000];
+
+    /// The single-threaded io_uring runloop that services all bridges via ring completions
+    fn runloop_uring(&self) -> Result<(), Error> {
+        // The TCP fan-out needs dedicated per-client threads
+        if self.bridges.iter().any(|bridge| bridge.tcp.is_some()) {
+            return Err(eio!("The TCP transport requires the threads engine"));
+        }
+
+        // The single loop thread services both directions, so pin it to the serial->UDP core
+        self.apply_sched(self.config.sched.serial2udp_cpu)?;
+        reload::register()?;
+
+        // Create the ring and keep both read directions of every bridge in flight
+        let mut ring = Uring::new(64)?;
+        let mut serials = Vec::new();
+        let mut generations = Vec::new();
+        let mut pipelines = Vec::new();
+        let mut serial_bufs = Vec::new();
+        let mut udp_bufs = Vec::new();
+        for (index, bridge) in self.bridges.iter().enumerate() {
+            let mut serial_buf = self.pool.lease_zeroed();
+            let mut udp_buf = self.pool.lease_zeroed();
+            let (serial, generation) = bridge.serial()?;
+            ring.submit_read(serial.as_raw_fd(), &mut serial_buf, (index * 2) as u64)?;
+            ring.submit_recv(bridge.socket.as_raw_fd(), &mut udp_buf, (index * 2 + 1) as u64)?;
+            serials.push(serial);
+            generations.push(generation);
+            pipelines.push(SerialPipeline::new(self, bridge)?);
+            serial_bufs.push(serial_buf);
+            udp_bufs.push(udp_buf);
+        }
+
+        // Service the completions
+        let mut completions = [Completion::default(); 8];
         loop {
-            // Receive UDP packet
-            let bytes_read = self.socket.recv(&mut buf)?;
-            if bytes_read > 0 {
-                // Write the message to the serial device
-                serial.write_all(&buf[..bytes_read])?;
-                self.log(&buf[..bytes_read]);
+            // Exit cleanly once a config reload has been requested
+            if reload::pending() {
+                return Ok(());
             }
+
+            // Wait until an operation completes, the earliest pipeline timer expires or the reload check is due
+            let timeout = Self::earliest_timeout(&pipelines).unwrap_or(RELOAD_CHECK).min(RELOAD_CHECK);
+            let count = match ring.wait(&mut completions, Some(timeout)) {
+                Ok(count) => count,
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+                Err(error) => return Err(error.into()),
+            };
+            for completion in &completions[..count] {
+                // Recover the bridge and direction from the user data tag
+                let (index, is_udp) = ((completion.user_data / 2) as usize, completion.user_data % 2 != 0);
+                let Some(bridge) = self.bridges.get(index) else { continue };
+                match is_udp {
+                    // Feed the serial chunk into the pipeline and rearm the read
+                    false => {
+                        let bytes_read = match completion.bytes() {
+                            Ok(bytes_read) => bytes_read,
+                            Err(error) if error.kind() == io::ErrorKind::Interrupted => 0,
+                            // Let the watchdog reopen a re-enumerated device instead of tearing the loop down
+                            Err(error) => match self.reopen_serial(bridge, &mut generations[index], &error) {
+                                Some(reopened) => {
+                                    serials[index] = reopened;
+                                    0
+                                }
+                                None => return Ok(()),
+                            },
+                        };
+                        self.stats.serial_read(bytes_read);
+                        self.capture(Direction::Serial2Udp, &serial_bufs[index][..bytes_read]);
+                        pipelines[index].push(&serial_bufs[index][..bytes_read]);
+                        ring.submit_read(serials[index].as_raw_fd(), &mut serial_bufs[index], completion.user_data)?;
+                    }
+                    // Write the datagram to the serial device and rearm the receive
+                    true => {
+                        let bytes_read = completion.bytes()?;
+                        self.stats.udp_received(bytes_read);
+                        if bytes_read > 0 {
+                            self.capture(Direction::Udp2Serial, &udp_bufs[index][..bytes_read]);
+                            match self.write_serial(&mut serials[index], &udp_bufs[index][..bytes_read]) {
+                                Ok(()) => self.log(&udp_bufs[index][..bytes_read]),
+                                // Reopen the device; the in-flight read on the dead descriptor errors out as well
+                                Err(error) => match self.reopen_serial(bridge, &mut generations[index], &error) {
+                                    Some(reopened) => serials[index] = reopened,
+                                    None => return Ok(()),
+                                },
+                            }
+                        }
+                        ring.submit_recv(bridge.socket.as_raw_fd(), &mut udp_bufs[index], completion.user_data)?;
+                    }
+                }
+            }
+
+            // Process timers and send pending packets
+            for pipeline in &mut pipelines {
+                pipeline.pump();
+            }
+        }
+    }
+
+    /// The serial drain runloop that services the serial device at line rate, regardless of network backpressure
+    fn runloop_serial_drain(
+        &self,
+        bridge: &Bridge,
+        mut serial: SerialDevice,
+        mut generation: u64,
+        ring: &Ring<Lease>,
+    ) -> Result<(), Error> {
+        self.apply_sched(self.config.sched.serial2udp_cpu)?;
+        reload::register()?;
+
+        // In adaptive mode the configured thresholds batch sustained traffic, with a forced inter-byte timeout so the
+        // tail of a burst is never stalled
+        let serial_config = &bridge.config.serial;
+        let batch_thresholds = (serial_config.vmin, serial_config.vtime.max(1));
+        let mut batching = false;
+        loop {
+            // Exit cleanly once a config reload has been requested, waking the sibling runloop threads
+            if reload::pending() {
+                reload::interrupt_all();
+                return Ok(());
+            }
+
+            // Read the next serial chunk into a leased buffer and hand it to the send thread
+            let mut buf = self.pool.lease_zeroed();
+            let bytes_read = match serial.read(&mut buf) {
+                Ok(bytes_read) => bytes_read,
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+                // Let the watchdog reopen a re-enumerated device instead of tearing the bridge down
+                Err(error) => match self.reopen_serial(bridge, &mut generation, &error) {
+                    Some(reopened) => {
+                        serial = reopened;
+                        batching = false;
+                        continue;
+                    }
+                    None => return Ok(()),
+                },
+            };
+            self.stats.serial_read(bytes_read);
+            buf.truncate(bytes_read);
+            self.capture(Direction::Serial2Udp, &buf);
+            ring.push(buf);
+            self.stats.queue_state(ring.len(), ring.take_dropped());
+
+            // Toggle between the batch and idle thresholds based on the observed arrival rate: a read that satisfies
+            // the batch threshold indicates sustained load, a shorter read indicates interactive traffic
+            let sustained = bytes_read >= serial_config.vmin as usize;
+            if serial_config.adaptive && batching != sustained {
+                batching = sustained;
+                let (vmin, vtime) = match batching {
+                    true => batch_thresholds,
+                    false => (1, 0),
+                };
+                // A failed retune means the descriptor has died, so let the watchdog reopen the device like a failed
+                // read instead of tearing the bridge down
+                if let Err(error) = serial.tune(vmin, vtime) {
+                    match self.reopen_serial(bridge, &mut generation, &error) {
+                        Some(reopened) => {
+                            serial = reopened;
+                            batching = false;
+                        }
+                        None => return Ok(()),
+                    }
+                }
+            }
+        }
+    }
+    /// The UDP send runloop that frames, coalesces and sends the drained serial chunks
+    fn runloop_udp_send(&self, bridge: &Bridge, ring: &Ring<Lease>) -> Result<(), Error> {
+        self.apply_sched(self.config.sched.serial2udp_cpu)?;
+        reload::register()?;
+        let mut pipeline = SerialPipeline::new(self, bridge)?;
+        loop {
+            // Exit cleanly once a config reload has been requested, waking the sibling runloop threads
+            if reload::pending() {
+                reload::interrupt_all();
+                return Ok(());
+            }
+
+            // Wait for the next serial chunk, but never past a pending pipeline timer or the reload check interval
+            let timeout = pipeline.timeout().unwrap_or(RELOAD_CHECK).min(RELOAD_CHECK);
+            if let Some(chunk) = ring.pop(Some(timeout)) {
+                pipeline.push(&chunk);
+            }
+
+            // Process timers and send pending packets
+            pipeline.pump();
+        }
+    }
+    /// The UDP receive runloop that queues incoming datagrams for the serial writer
+    ///
+    /// The bounded queue decouples the receiver from the slow serial link, so overload behavior is governed by the
+    /// configured write policy instead of the kernel silently dropping arbitrary socket buffer contents
+    fn runloop_udp_recv(&self, bridge: &Bridge, write_queue: &Queue<Lease>) -> Result<(), Error> {
+        self.apply_sched(self.config.sched.udp2serial_cpu)?;
+        reload::register()?;
+        let mut batch = Batch::new(bridge.config.udp.batch, self.pool.size());
+        loop {
+            // Exit cleanly once a config reload has been requested, waking the sibling runloop threads
+            if reload::pending() {
+                reload::interrupt_all();
+                return Ok(());
+            }
+
+            // Receive up to a batch of UDP packets in a single syscall
+            let received = match batch.recv(&bridge.socket) {
+                Ok(received) => received,
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+                Err(error) => return Err(error.into()),
+            };
+            self.stats.udp_truncated(batch.take_truncated());
+            bridge.track_peers(&batch, received);
+            for index in 0..received {
+                // Queue the datagram for the serial writer
+                let datagram = batch.datagram(index);
+                self.stats.udp_received(datagram.len());
+                if !datagram.is_empty() {
+                    let mut buf = self.pool.lease();
+                    buf.extend_from_slice(datagram);
+                    write_queue.push(buf);
+                    self.stats.write_queue_state(write_queue.len(), write_queue.take_dropped());
+                }
+            }
+        }
+    }
+    /// The serial write runloop that drains the queued datagrams into the serial device
+    fn runloop_serial_write(
+        &self,
+        bridge: &Bridge,
+        mut serial: SerialDevice,
+        mut generation: u64,
+        write_queue: &Queue<Lease>,
+    ) -> Result<(), Error> {
+        self.apply_sched(self.config.sched.udp2serial_cpu)?;
+        reload::register()?;
+        loop {
+            // Exit cleanly once a config reload has been requested, waking the sibling runloop threads
+            if reload::pending() {
+                reload::interrupt_all();
+                return Ok(());
+            }
+
+            // Write the next queued datagram to the serial device
+            let Some(datagram) = write_queue.pop_timeout(RELOAD_CHECK) else { continue };
+            self.capture(Direction::Udp2Serial, &datagram);
+            if let Err(error) = self.write_serial(&mut serial, &datagram) {
+                // Let the watchdog reopen a re-enumerated device; the current datagram is lost with the device
+                match self.reopen_serial(bridge, &mut generation, &error) {
+                    Some(reopened) => serial = reopened,
+                    None => return Ok(()),
+                }
+                continue;
+            }
+            self.log(&datagram);
+        }
+    }
+
+    /// Reopens the serial device of the bridge with exponential backoff after its descriptor has died
+    ///
+    /// USB-serial adapters disappear and return under the same path when they re-enumerate, so the watchdog keeps the
+    /// sockets and the buffer pool alive and retries the path until it can be opened again – restoring the bridge in
+    /// tens of milliseconds instead of a full process restart. Returns `None` once a config reload has been requested
+    ///
+    /// A reopened device is published back into the bridge's serial slot, so the reload retention hands the live
+    /// descriptor to the next server; `generation` is the caller's view of the slot and lets it adopt a device that
+    /// the sibling runloop thread has already reopened instead of opening a second descriptor onto the same path
+    fn reopen_serial(&self, bridge: &Bridge, generation: &mut u64, error: &dyn fmt::Display) -> Option<SerialDevice> {
+        // Surface the outage and retry the path with exponential backoff
+        let serial_config = &bridge.config.serial;
+        eprintln!("Serial device {} is gone ({error}), waiting for it to return", serial_config.device);
+        let rtscts = serial_config.flow_control == config::FlowControl::Rtscts;
+        let mut backoff = WATCHDOG_BACKOFF_MIN;
+        loop {
+            // Give up cleanly once a config reload has been requested
+            if reload::pending() {
+                reload::interrupt_all();
+                return None;
+            }
+
+            // Adopt the device if the sibling runloop thread has already reopened and published it
+            if let Some(adopted) = bridge.adopt_serial(generation) {
+                return Some(adopted);
+            }
+
+            // Back off before the attempt, so a device that dies right after opening cannot busy-loop the watchdog
+            thread::sleep(backoff);
+            backoff = (backoff * 2).min(WATCHDOG_BACKOFF_MAX);
+
+            // Reopen the device and reapply the read thresholds and the low-latency tuning
+            let serial = SerialDevice::new(&serial_config.device, serial_config.baudrate, rtscts, serial_config.drain);
+            if let Ok(serial) = serial {
+                let thresholds = match serial_config.adaptive {
+                    true => (1, 0),
+                    false => (serial_config.vmin, serial_config.vtime),
+                };
+                let tuned = serial.tune(thresholds.0, thresholds.1).is_ok()
+                    && (!serial_config.low_latency || serial.low_latency(&serial_config.device).is_ok());
+                if tuned {
+                    // Publish the device so the sibling thread and the reload retention see the live descriptor
+                    if let Some(serial) = bridge.publish_serial(serial, generation) {
+                        eprintln!("Serial device {} is back", serial_config.device);
+                        return Some(serial);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Applies the configured CPU pinning and realtime scheduling to the calling runloop thread
+    fn apply_sched(&self, cpu: Option<usize>) -> Result<(), Error> {
+        // Pin the thread to the configured core
+        if let Some(cpu) = cpu {
+            sched::set_affinity(cpu)?;
+        }
+
+        // Elevate the thread to the configured realtime priority
+        if self.config.sched.priority > 0 {
+            sched::set_realtime(self.config.sched.priority)?;
+        }
+        Ok(())
+    }
+
+    /// The earliest pending pipeline timer over all bridges
+    fn earliest_timeout(pipelines: &[SerialPipeline]) -> Option<Duration> {
+        let timeouts = pipelines.iter().filter_map(SerialPipeline::timeout);
+        timeouts.min()
+    }
+
+    /// Writes an entire datagram to the serial device, waiting for writability if the device is nonblocking
+    fn write_serial(&self, serial: &mut SerialDevice, mut data: &[u8]) -> Result<(), Error> {
+        while !data.is_empty() {
+            match serial.write(data) {
+                Ok(written) => data = &data[written..],
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => (),
+                Err(error) if error.kind() == io::ErrorKind::WouldBlock => {
+                    // Wait until the device can accept more output data
+                    serial.poll_writable(Duration::from_millis(100))?;
+                }
+                Err(error) => return Err(error.into()),
+            }
+        }
+        serial.flush()?;
+        Ok(())
+    }
+
+    /// Records the data into the capture ring if the flight recorder is enabled
+    fn capture(&self, direction: Direction, data: &[u8]) {
+        // Unwrap the recorder if available
+        if let Some(recorder) = self.capture.as_ref() {
+            // Record the data
+            recorder.record(direction, data);
         }
     }
 
     /// Logs the data if there is a logger available
     fn log(&self, data: &[u8]) {
         // Unwrap the logger if available
-        if let Some(logger) = self.logger {
+        if let Some(logger) = self.logger.as_ref() {
             // Log the data
             logger.log(data);
         }
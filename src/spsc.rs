@@ -0,0 +1,118 @@
+//! Implements a lock-free single-producer/single-consumer ring buffer
+
+use std::{
+    cell::UnsafeCell,
+    sync::{
+        atomic::{AtomicU64, AtomicUsize, Ordering},
+        OnceLock,
+    },
+    thread::{self, Thread},
+    time::{Duration, Instant},
+};
+
+/// A lock-free single-producer/single-consumer ring buffer
+///
+/// `push` must only ever be called from one producer thread and `pop` from one consumer thread; if the ring is full,
+/// pushed items are dropped and counted so the producer never stalls
+pub struct Ring<T> {
+    /// The item slots
+    slots: Box<[UnsafeCell<Option<T>>]>,
+    /// The consumer position
+    head: AtomicUsize,
+    /// The producer position
+    tail: AtomicUsize,
+    /// The amount of items that have been dropped because the ring was full
+    dropped: AtomicU64,
+    /// The consumer thread to unpark when the ring transitions from empty to non-empty
+    consumer: OnceLock<Thread>,
+}
+unsafe impl<T: Send> Sync for Ring<T> {}
+impl<T> Ring<T> {
+    /// Creates a new ring with the given capacity
+    pub fn new(capacity: usize) -> Self {
+        let slots = (0..capacity.max(2)).map(|_| UnsafeCell::new(None)).collect();
+        Self {
+            slots,
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            dropped: AtomicU64::new(0),
+            consumer: OnceLock::new(),
+        }
+    }
+
+    /// The amount of items currently queued in the ring
+    pub fn len(&self) -> usize {
+        let (head, tail) = (self.head.load(Ordering::Relaxed), self.tail.load(Ordering::Relaxed));
+        tail.wrapping_sub(head)
+    }
+    /// Whether the ring is empty or not
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Takes the amount of items that have been dropped because the ring was full since the last call
+    pub fn take_dropped(&self) -> u64 {
+        self.dropped.swap(0, Ordering::Relaxed)
+    }
+
+    /// Pushes an item into the ring, dropping it if the ring is full
+    pub fn push(&self, item: T) {
+        // Drop the item if the ring is full
+        let tail = self.tail.load(Ordering::Relaxed);
+        let head = self.head.load(Ordering::Acquire);
+        if tail.wrapping_sub(head) >= self.slots.len() {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+
+        // Store and publish the item. The tail store and the head re-load below must be sequentially consistent
+        // against the consumer's head store and tail re-check (the store-buffer litmus test): with weaker orderings
+        // both sides can read the stale counter, so the producer skips the unpark while the consumer parks with a
+        // published item in the ring, stranding it until the pop timeout
+        let slot = self.slots[tail % self.slots.len()].get();
+        unsafe { *slot = Some(item) };
+        self.tail.store(tail.wrapping_add(1), Ordering::SeqCst);
+
+        // Wake the consumer if it may have observed the ring as empty before the publish
+        let head = self.head.load(Ordering::SeqCst);
+        if tail == head {
+            if let Some(consumer) = self.consumer.get() {
+                consumer.unpark();
+            }
+        }
+    }
+
+    /// Takes the next item out of the ring, waiting up to `timeout` for the producer (`None` waits forever)
+    pub fn pop(&self, timeout: Option<Duration>) -> Option<T> {
+        // Register the calling thread for producer wakeups
+        let _ = self.consumer.set(thread::current());
+
+        // Wait for the next item
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        loop {
+            // Take the next item if one is available. The head store and the tail load pair with the producer's
+            // sequentially consistent publish (see `push`), so the empty-check before parking can never miss an item
+            // whose publish skipped the unpark
+            let head = self.head.load(Ordering::Relaxed);
+            let tail = self.tail.load(Ordering::SeqCst);
+            if head != tail {
+                let slot = self.slots[head % self.slots.len()].get();
+                let item = unsafe { (*slot).take() };
+                self.head.store(head.wrapping_add(1), Ordering::SeqCst);
+                return item;
+            }
+
+            // Park until the producer publishes an item or the timeout expires
+            match deadline {
+                Some(deadline) => {
+                    let remaining = deadline.saturating_duration_since(Instant::now());
+                    if remaining.is_zero() {
+                        return None;
+                    }
+                    thread::park_timeout(remaining);
+                }
+                None => thread::park(),
+            }
+        }
+    }
+}
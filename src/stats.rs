@@ -0,0 +1,237 @@
+//! Implements cheap hot-path instrumentation with counters and latency histograms
+
+#[cfg(feature = "stats")]
+use std::sync::{
+    atomic::{AtomicU64, Ordering},
+    Arc,
+};
+use std::time::Duration;
+
+/// Collects hot-path counters and a serial-read->udp-send latency histogram
+///
+/// All counters are relaxed atomics, so recording costs a single uncontended memory operation on the hot path. If the
+/// `stats` feature is disabled, the struct is empty and all methods compile to no-ops.
+#[derive(Debug, Default, Clone)]
+pub struct Stats {
+    /// The shared counters
+    #[cfg(feature = "stats")]
+    inner: Arc<Inner>,
+}
+
+/// The shared counters
+#[cfg(feature = "stats")]
+#[derive(Debug, Default)]
+struct Inner {
+    /// The amount of serial chunks read
+    serial_chunks: AtomicU64,
+    /// The amount of serial bytes read
+    serial_bytes: AtomicU64,
+    /// The amount of empty serial reads
+    short_reads: AtomicU64,
+    /// The amount of UDP packets produced by the serial->UDP pipeline
+    udp_tx_packets: AtomicU64,
+    /// The amount of UDP payload bytes produced by the serial->UDP pipeline
+    udp_tx_bytes: AtomicU64,
+    /// The amount of failed sends
+    send_errors: AtomicU64,
+    /// The amount of UDP packets received
+    udp_rx_packets: AtomicU64,
+    /// The amount of UDP payload bytes received
+    udp_rx_bytes: AtomicU64,
+    /// The amount of received datagrams that have been truncated because they exceeded a receive slot
+    udp_truncated: AtomicU64,
+    /// The current depth of the drain->send handoff queue
+    queue_depth: AtomicU64,
+    /// The amount of chunks dropped because the handoff queue was full
+    queue_dropped: AtomicU64,
+    /// The current depth of the UDP->serial write queue
+    write_queue_depth: AtomicU64,
+    /// The amount of datagrams dropped because the write queue was full
+    write_queue_dropped: AtomicU64,
+    /// The serial-read->udp-send latency histogram with one log2 bucket per power of two microseconds
+    latency: [AtomicU64; 32],
+}
+
+impl Stats {
+    /// Records a serial read of `bytes` bytes
+    #[inline]
+    pub fn serial_read(&self, bytes: usize) {
+        #[cfg(feature = "stats")]
+        match bytes {
+            0 => _ = self.inner.short_reads.fetch_add(1, Ordering::Relaxed),
+            bytes => {
+                self.inner.serial_chunks.fetch_add(1, Ordering::Relaxed);
+                self.inner.serial_bytes.fetch_add(bytes as u64, Ordering::Relaxed);
+            }
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = bytes;
+    }
+
+    /// Records an outgoing UDP packet of `bytes` bytes
+    #[inline]
+    pub fn udp_sent(&self, bytes: usize) {
+        #[cfg(feature = "stats")]
+        {
+            self.inner.udp_tx_packets.fetch_add(1, Ordering::Relaxed);
+            self.inner.udp_tx_bytes.fetch_add(bytes as u64, Ordering::Relaxed);
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = bytes;
+    }
+
+    /// Records a failed send
+    #[inline]
+    pub fn send_error(&self) {
+        #[cfg(feature = "stats")]
+        self.inner.send_errors.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records an incoming UDP packet of `bytes` bytes
+    #[inline]
+    pub fn udp_received(&self, bytes: usize) {
+        #[cfg(feature = "stats")]
+        {
+            self.inner.udp_rx_packets.fetch_add(1, Ordering::Relaxed);
+            self.inner.udp_rx_bytes.fetch_add(bytes as u64, Ordering::Relaxed);
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = bytes;
+    }
+
+    /// Records `truncated` newly truncated datagrams observed on a receive path
+    ///
+    /// The counter is accumulated so multiple bridges cannot overwrite each other's truncations
+    #[inline]
+    pub fn udp_truncated(&self, truncated: u64) {
+        #[cfg(feature = "stats")]
+        if truncated > 0 {
+            self.inner.udp_truncated.fetch_add(truncated, Ordering::Relaxed);
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = truncated;
+    }
+
+    /// Records the current depth of a drain->send handoff queue and `dropped` newly dropped chunks
+    ///
+    /// The depth is a sampled gauge, while the drop counter is accumulated so multiple bridges cannot overwrite each
+    /// other's drops
+    #[inline]
+    pub fn queue_state(&self, depth: usize, dropped: u64) {
+        #[cfg(feature = "stats")]
+        {
+            self.inner.queue_depth.store(depth as u64, Ordering::Relaxed);
+            if dropped > 0 {
+                self.inner.queue_dropped.fetch_add(dropped, Ordering::Relaxed);
+            }
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = (depth, dropped);
+    }
+
+    /// Records the current depth of a UDP->serial write queue and `dropped` newly dropped datagrams
+    ///
+    /// The depth is a sampled gauge, while the drop counter is accumulated so multiple bridges cannot overwrite each
+    /// other's drops
+    #[inline]
+    pub fn write_queue_state(&self, depth: usize, dropped: u64) {
+        #[cfg(feature = "stats")]
+        {
+            self.inner.write_queue_depth.store(depth as u64, Ordering::Relaxed);
+            if dropped > 0 {
+                self.inner.write_queue_dropped.fetch_add(dropped, Ordering::Relaxed);
+            }
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = (depth, dropped);
+    }
+
+    /// Records a serial-read->udp-send latency sample
+    #[inline]
+    pub fn latency(&self, elapsed: Duration) {
+        #[cfg(feature = "stats")]
+        {
+            // Bucket the sample by the log2 of its microseconds
+            let us = elapsed.as_micros().max(1) as u64;
+            let bucket = (63 - us.leading_zeros() as usize).min(31);
+            self.inner.latency[bucket].fetch_add(1, Ordering::Relaxed);
+        }
+        #[cfg(not(feature = "stats"))]
+        let _ = elapsed;
+    }
+
+    /// The amount of serial chunks read so far (one bulk read syscall each)
+    pub fn serial_chunks(&self) -> u64 {
+        #[cfg(feature = "stats")]
+        return self.inner.serial_chunks.load(Ordering::Relaxed);
+        #[cfg(not(feature = "stats"))]
+        0
+    }
+    /// The amount of UDP packets produced by the serial->UDP pipeline so far
+    pub fn udp_tx_packets(&self) -> u64 {
+        #[cfg(feature = "stats")]
+        return self.inner.udp_tx_packets.load(Ordering::Relaxed);
+        #[cfg(not(feature = "stats"))]
+        0
+    }
+
+    /// Formats the current counters into a one-line summary
+    pub fn format(&self) -> String {
+        #[cfg(feature = "stats")]
+        {
+            // Snapshot the counters
+            let inner = self.inner.as_ref();
+            let (chunks, bytes) =
+                (inner.serial_chunks.load(Ordering::Relaxed), inner.serial_bytes.load(Ordering::Relaxed));
+            let short_reads = inner.short_reads.load(Ordering::Relaxed);
+            let (tx, tx_bytes) =
+                (inner.udp_tx_packets.load(Ordering::Relaxed), inner.udp_tx_bytes.load(Ordering::Relaxed));
+            let send_errors = inner.send_errors.load(Ordering::Relaxed);
+            let (rx, rx_bytes) =
+                (inner.udp_rx_packets.load(Ordering::Relaxed), inner.udp_rx_bytes.load(Ordering::Relaxed));
+            let truncated = inner.udp_truncated.load(Ordering::Relaxed);
+            let (depth, dropped) =
+                (inner.queue_depth.load(Ordering::Relaxed), inner.queue_dropped.load(Ordering::Relaxed));
+            let (write_depth, write_dropped) =
+                (inner.write_queue_depth.load(Ordering::Relaxed), inner.write_queue_dropped.load(Ordering::Relaxed));
+
+            // Summarize the latency histogram
+            let latency: Vec<u64> = inner.latency.iter().map(|bucket| bucket.load(Ordering::Relaxed)).collect();
+            let (p50, p99, max) = Self::latency_summary(&latency);
+            format!(
+                "stats: serial rx {chunks} chunks/{bytes} B ({short_reads} short reads), \
+                 udp tx {tx} pkts/{tx_bytes} B ({send_errors} errors), \
+                 udp rx {rx} pkts/{rx_bytes} B ({truncated} truncated), \
+                 queue depth {depth} ({dropped} dropped), write queue depth {write_depth} ({write_dropped} dropped), \
+                 latency p50 ~{p50}us p99 ~{p99}us max ~{max}us"
+            )
+        }
+        #[cfg(not(feature = "stats"))]
+        String::new()
+    }
+
+    /// Computes the approximate p50/p99/max latencies in microseconds from the histogram buckets
+    #[cfg(feature = "stats")]
+    fn latency_summary(buckets: &[u64]) -> (u64, u64, u64) {
+        // Find the buckets that cross the percentile thresholds
+        let total: u64 = buckets.iter().sum();
+        let mut p50 = 0;
+        let mut p99 = 0;
+        let mut max = 0;
+        let mut cumulative = 0;
+        for (index, &count) in buckets.iter().enumerate() {
+            // Each bucket represents the power of two microseconds of its index
+            cumulative += count;
+            if p50 == 0 && total > 0 && cumulative * 2 >= total {
+                p50 = 1 << index;
+            }
+            if p99 == 0 && total > 0 && cumulative * 100 >= total * 99 {
+                p99 = 1 << index;
+            }
+            if count > 0 {
+                max = 1 << index;
+            }
+        }
+        (p50, p99, max)
+    }
+}
@@ -0,0 +1,97 @@
+//! Implements a fixed-size, lock-free registry of recently seen UDP peers
+
+use std::{
+    net::{Ipv4Addr, SocketAddr},
+    sync::atomic::{AtomicU64, Ordering},
+    time::{Duration, Instant},
+};
+
+/// A fixed-size, lock-free registry of recently seen UDP peers
+///
+/// Peers are tracked on a best-effort basis: concurrent insertions may race for a slot, in which case an entry can be
+/// lost or briefly duplicated. Only IPv4 peers are tracked, as only those fit into a single atomic slot.
+pub struct Registry {
+    /// The packed peer addresses (IPv4 address in the upper bits, port in the lower 16 bits; `0` marks an empty slot)
+    peers: Box<[AtomicU64]>,
+    /// The time a peer has last been seen, in milliseconds since `epoch`
+    seen: Box<[AtomicU64]>,
+    /// The time after which an idle peer expires
+    ttl: Duration,
+    /// The reference point for the per-slot timestamps
+    epoch: Instant,
+}
+impl Registry {
+    /// Creates a new registry that tracks up to `count` peers with the given idle expiry
+    pub fn new(count: usize, ttl: Duration) -> Self {
+        let peers = (0..count.max(1)).map(|_| AtomicU64::new(0)).collect();
+        let seen = (0..count.max(1)).map(|_| AtomicU64::new(0)).collect();
+        Self { peers, seen, ttl, epoch: Instant::now() }
+    }
+
+    /// Registers a peer or refreshes its expiry if it is already tracked
+    pub fn insert(&self, peer: SocketAddr) {
+        // Only IPv4 peers fit into an atomic slot
+        let Some(packed) = Self::pack(peer) else { return };
+        let now = self.epoch.elapsed().as_millis() as u64;
+        let ttl = self.ttl.as_millis() as u64;
+
+        // Refresh the peer if it is already tracked
+        for (slot, seen) in self.peers.iter().zip(self.seen.iter()) {
+            if slot.load(Ordering::Relaxed) == packed {
+                seen.store(now, Ordering::Relaxed);
+                return;
+            }
+        }
+
+        // Claim the first empty or expired slot, falling back to the stalest slot if the registry is full
+        let (mut victim, mut victim_seen) = (0, u64::MAX);
+        for (index, (slot, seen)) in self.peers.iter().zip(self.seen.iter()).enumerate() {
+            // Take a free or expired slot immediately
+            let (peer, last_seen) = (slot.load(Ordering::Relaxed), seen.load(Ordering::Relaxed));
+            if peer == 0 || now.saturating_sub(last_seen) >= ttl {
+                (victim, victim_seen) = (index, 0);
+                break;
+            }
+
+            // Remember the stalest slot as fallback
+            if last_seen < victim_seen {
+                (victim, victim_seen) = (index, last_seen);
+            }
+        }
+        let _ = victim_seen;
+
+        // Publish the peer with a fresh timestamp
+        self.seen[victim].store(now, Ordering::Relaxed);
+        self.peers[victim].store(packed, Ordering::Release);
+    }
+
+    /// Collects all peers that have not expired into `out`
+    pub fn collect(&self, out: &mut Vec<SocketAddr>) {
+        out.clear();
+        let now = self.epoch.elapsed().as_millis() as u64;
+        let ttl = self.ttl.as_millis() as u64;
+        for (slot, seen) in self.peers.iter().zip(self.seen.iter()) {
+            // Unpack the peer if the slot is populated and not expired
+            let (packed, last_seen) = (slot.load(Ordering::Acquire), seen.load(Ordering::Relaxed));
+            if packed != 0 && now.saturating_sub(last_seen) < ttl {
+                out.push(Self::unpack(packed));
+            }
+        }
+    }
+
+    /// Packs an IPv4 peer address into a single nonzero integer
+    fn pack(peer: SocketAddr) -> Option<u64> {
+        match peer {
+            SocketAddr::V4(peer) => {
+                let ip = u32::from(*peer.ip()) as u64;
+                Some((ip << 16) | peer.port() as u64).filter(|packed| *packed != 0)
+            }
+            SocketAddr::V6(_) => None,
+        }
+    }
+    /// Unpacks a peer address from its packed form
+    fn unpack(packed: u64) -> SocketAddr {
+        let ip = Ipv4Addr::from((packed >> 16) as u32);
+        SocketAddr::from((ip, packed as u16))
+    }
+}
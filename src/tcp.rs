@@ -0,0 +1,200 @@
+//! Implements the TCP fan-out for the serial stream
+
+use crate::{
+    error::Error,
+    pool::{Lease, Pool},
+    queue::{Policy, Queue},
+    reload,
+    serial::SerialDevice,
+    stats::Stats,
+};
+use std::{
+    io::{self, IoSlice, Read, Write},
+    net::{Shutdown, TcpListener, TcpStream},
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        Arc, Mutex,
+    },
+    thread,
+    time::Duration,
+};
+
+/// The maximum amount of queued chunks to coalesce into a single vectored write
+const WRITE_BATCH: usize = 16;
+/// The interval at which an idle writer thread re-checks its client's dead flag
+const DEAD_CHECK: Duration = Duration::from_millis(250);
+
+/// A connected TCP client
+struct Client {
+    /// The bounded queue of framed chunks pending for this client
+    queue: Queue<Lease>,
+    /// Whether the client has disconnected and should be pruned
+    dead: AtomicBool,
+    /// The client's stream, so the fan-out can disconnect the client on teardown
+    stream: TcpStream,
+}
+
+/// Fans the framed serial stream out to all connected TCP clients
+///
+/// Each client gets its own bounded send queue serviced by a dedicated writer thread, so one slow client stalls
+/// neither the serial pipeline nor the other clients: if a client's queue is full, further chunks are dropped for that
+/// client only. Data received from a client is written back to the serial device
+pub struct Fanout {
+    /// The connected clients
+    clients: Mutex<Vec<Arc<Client>>>,
+    /// Whether to disable Nagle's algorithm on accepted connections
+    nodelay: bool,
+    /// The depth of the per-client send queue
+    depth: usize,
+}
+impl Fanout {
+    /// Creates a new TCP fan-out
+    pub fn new(nodelay: bool, depth: usize) -> Self {
+        Self { clients: Mutex::new(Vec::new()), nodelay, depth }
+    }
+
+    /// Queues a framed chunk for every connected client, pruning disconnected clients
+    pub fn broadcast(&self, pool: &Pool, buf: &[u8]) {
+        // Prune the disconnected clients and queue the chunk for the remaining ones
+        let mut clients = self.clients.lock().expect("Client list mutex is poisoned");
+        clients.retain(|client| !client.dead.load(Ordering::Relaxed));
+        for client in clients.iter() {
+            let mut chunk = pool.lease();
+            chunk.extend_from_slice(buf);
+            client.queue.push(chunk);
+        }
+    }
+
+    /// The acceptor runloop that registers incoming clients and spawns their writer and reader threads
+    pub fn runloop_acceptor(&self, listener: TcpListener, serial: SerialDevice, stats: Stats) -> Result<(), Error> {
+        reload::register()?;
+        loop {
+            // Exit cleanly once a config reload has been requested, waking the sibling runloop threads
+            if reload::pending() {
+                reload::interrupt_all();
+                return Ok(());
+            }
+
+            // Accept the next client, dropping it again if its per-client setup fails: a client whose stream cannot
+            // be configured or duplicated must not take down the entire fan-out
+            let (stream, peer) = match listener.accept() {
+                Ok(accepted) => accepted,
+                Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+                Err(error) => return Err(error.into()),
+            };
+            if let Err(error) = self.setup_client(stream, &serial, &stats) {
+                eprintln!("Dropping TCP client {peer}: {error}");
+            }
+        }
+    }
+
+    /// Configures an accepted client, registers it and spawns its writer and reader threads
+    ///
+    /// All fallible per-client setup happens before the client is registered, so a failure leaves the fan-out
+    /// untouched and only drops this one client
+    fn setup_client(&self, stream: TcpStream, serial: &SerialDevice, stats: &Stats) -> io::Result<()> {
+        // Configure the stream and duplicate the descriptors for the client's threads
+        stream.set_nodelay(self.nodelay)?;
+        let client_stream = stream.try_clone()?;
+        let writer_stream = stream.try_clone()?;
+        let reader_serial = serial.try_clone()?;
+
+        // Register the client and spawn its writer and reader threads
+        let client = Arc::new(Client {
+            queue: Queue::new(self.depth, Policy::DropNewest),
+            dead: AtomicBool::new(false),
+            stream: client_stream,
+        });
+        (self.clients.lock().expect("Client list mutex is poisoned")).push(client.clone());
+        let writer_client = client.clone();
+        thread::spawn(move || Self::runloop_writer(&writer_client, writer_stream));
+        let reader_stats = stats.clone();
+        thread::spawn(move || Self::runloop_reader(&client, stream, reader_serial, reader_stats));
+        Ok(())
+    }
+
+    /// The per-client writer runloop that drains the client's send queue with vectored writes
+    fn runloop_writer(client: &Client, mut stream: TcpStream) {
+        loop {
+            // Wait for the next chunk, exiting once the client has been marked dead (e.g. on fan-out teardown)
+            let Some(first) = client.queue.pop_timeout(DEAD_CHECK) else {
+                match client.dead.load(Ordering::Relaxed) {
+                    true => return,
+                    false => continue,
+                }
+            };
+
+            // Drain whatever else is already queued
+            let mut chunks = vec![first];
+            while chunks.len() < WRITE_BATCH {
+                match client.queue.try_pop() {
+                    Some(chunk) => chunks.push(chunk),
+                    None => break,
+                }
+            }
+
+            // Write the chunks and mark the client dead on failure
+            if Self::write_chunks(&mut stream, &chunks).is_err() {
+                client.dead.store(true, Ordering::Relaxed);
+                return;
+            }
+        }
+    }
+
+    /// The per-client reader runloop that writes received data back to the serial device
+    fn runloop_reader(client: &Client, mut stream: TcpStream, mut serial: SerialDevice, stats: Stats) {
+        let mut buf = [0; 4096];
+        loop {
+            // Read the next chunk from the client
+            let bytes_read = match stream.read(&mut buf) {
+                Ok(0) | Err(_) => {
+                    client.dead.store(true, Ordering::Relaxed);
+                    return;
+                }
+                Ok(bytes_read) => bytes_read,
+            };
+
+            // Write the chunk to the serial device
+            stats.udp_received(bytes_read);
+            if serial.write_all(&buf[..bytes_read]).and_then(|_| serial.flush()).is_err() {
+                client.dead.store(true, Ordering::Relaxed);
+                return;
+            }
+        }
+    }
+
+    /// Writes all chunks to the stream with as few syscalls as possible
+    fn write_chunks(stream: &mut TcpStream, chunks: &[Lease]) -> io::Result<()> {
+        // Write the remaining chunks in a single vectored syscall per iteration
+        let (mut index, mut offset) = (0, 0);
+        while index < chunks.len() {
+            // Gather the unwritten parts of the chunks
+            let first = IoSlice::new(&chunks[index][offset..]);
+            let rest = chunks[index + 1..].iter().map(|chunk| IoSlice::new(chunk));
+            let slices: Vec<IoSlice> = std::iter::once(first).chain(rest).collect();
+            let mut written = stream.write_vectored(&slices)?;
+            if written == 0 {
+                return Err(io::Error::from(io::ErrorKind::WriteZero));
+            }
+
+            // Advance past the fully written chunks
+            while index < chunks.len() && written >= chunks[index].len() - offset {
+                written -= chunks[index].len() - offset;
+                offset = 0;
+                index += 1;
+            }
+            offset += written;
+        }
+        Ok(())
+    }
+}
+impl Drop for Fanout {
+    fn drop(&mut self) {
+        // Disconnect the remaining clients so their writer and reader threads exit (e.g. on a config reload)
+        let clients = self.clients.lock().expect("Client list mutex is poisoned");
+        for client in clients.iter() {
+            client.dead.store(true, Ordering::Relaxed);
+            let _ = client.stream.shutdown(Shutdown::Both);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+//! Provides a minimal io_uring wrapper for the io_uring engine
+
+use std::{ffi::c_void, io, os::fd::RawFd, time::Duration};
+
+extern "C" {
+    // void* uring_create(uint32_t entries)
+    fn uring_create(entries: u32) -> *mut c_void;
+
+    // int32_t uring_submit_read(void* ring, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data)
+    fn uring_submit_read(ring: *mut c_void, fd: i32, buf: *mut u8, len: u64, user_data: u64) -> i32;
+
+    // int32_t uring_submit_recv(void* ring, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data)
+    fn uring_submit_recv(ring: *mut c_void, fd: i32, buf: *mut u8, len: u64, user_data: u64) -> i32;
+
+    // int32_t uring_wait(void* ring, struct uring_completion* completions, uint32_t max, int32_t timeout_ms)
+    fn uring_wait(ring: *mut c_void, completions: *mut Completion, max: u32, timeout_ms: i32) -> i32;
+
+    // void uring_destroy(void* ring)
+    fn uring_destroy(ring: *mut c_void);
+}
+
+/// A completed io_uring operation (layout-compatible with `struct uring_completion` in the C shim)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct Completion {
+    /// The user data tag the operation was submitted with
+    pub user_data: u64,
+    /// The operation result (the raw syscall-style result, negative values are negated errnos)
+    pub result: i64,
+}
+impl Completion {
+    /// The operation result as amount of bytes transferred
+    pub fn bytes(&self) -> io::Result<usize> {
+        match self.result >= 0 {
+            true => Ok(self.result as usize),
+            false => Err(io::Error::from_raw_os_error(-self.result as i32)),
+        }
+    }
+}
+
+/// A minimal io_uring instance
+///
+/// # Warning
+/// Buffers passed to the submit calls are handed to the kernel and must stay valid and unmoved until the associated
+/// operation completes
+pub struct Uring {
+    /// The opaque ring handle
+    ring: *mut c_void,
+}
+impl Uring {
+    /// Creates a new io_uring instance with the given submission queue size
+    pub fn new(entries: u32) -> io::Result<Self> {
+        // Create the ring
+        let ring = unsafe { uring_create(entries) };
+        if ring.is_null() {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(Self { ring })
+    }
+
+    /// Queues a read of the descriptor into the buffer
+    pub fn submit_read(&mut self, fd: RawFd, buf: &mut [u8], user_data: u64) -> io::Result<()> {
+        // Queue the operation
+        let result = unsafe { uring_submit_read(self.ring, fd, buf.as_mut_ptr(), buf.len() as u64, user_data) };
+        if result < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(())
+    }
+
+    /// Queues a datagram receive from the descriptor into the buffer
+    pub fn submit_recv(&mut self, fd: RawFd, buf: &mut [u8], user_data: u64) -> io::Result<()> {
+        // Queue the operation
+        let result = unsafe { uring_submit_recv(self.ring, fd, buf.as_mut_ptr(), buf.len() as u64, user_data) };
+        if result < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(())
+    }
+
+    /// Submits all queued operations and waits for completions (`None` waits forever)
+    pub fn wait(&mut self, completions: &mut [Completion], timeout: Option<Duration>) -> io::Result<usize> {
+        // Prepare the timeout
+        let timeout_ms = match timeout {
+            Some(timeout) => i32::try_from(timeout.as_millis()).unwrap_or(i32::MAX),
+            None => -1,
+        };
+
+        // Wait for the completions
+        let max = completions.len() as u32;
+        let count = unsafe { uring_wait(self.ring, completions.as_mut_ptr(), max, timeout_ms) };
+        if count < 0 {
+            let errno = io::Error::last_os_error();
+            return Err(errno);
+        }
+        Ok(count as usize)
+    }
+}
+impl Drop for Uring {
+    fn drop(&mut self) {
+        unsafe { uring_destroy(self.ring) }
+    }
+}
@@ -0,0 +1,286 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <errno.h>
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// The user data tag reserved for internal timeout operations
+#define URING_TIMEOUT_DATA UINT64_MAX
+
+/// A completed operation
+struct uring_completion {
+    /// The user data tag the operation was submitted with
+    uint64_t user_data;
+    /// The operation result (syscall-style, negative values are negated errnos)
+    int64_t result;
+};
+
+/// A minimal io_uring instance
+struct uring {
+    /// The ring file descriptor
+    int fd;
+    /// The submission queue ring mapping and its size
+    uint8_t* sq_ring;
+    size_t sq_ring_size;
+    /// The submission queue entries mapping and its size
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    /// The submission queue pointers
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t* sq_mask;
+    uint32_t* sq_entries;
+    uint32_t* sq_array;
+    /// The completion queue ring mapping and its size
+    uint8_t* cq_ring;
+    size_t cq_ring_size;
+    /// The completion queue pointers
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    uint32_t* cq_mask;
+    struct io_uring_cqe* cqes;
+    /// The amount of prepared-but-unsubmitted entries
+    uint32_t to_submit;
+    /// The timespec backing pending timeout operations
+    struct __kernel_timespec timeout;
+};
+
+/**
+ * @brief The raw `io_uring_setup` syscall
+ */
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+/**
+ * @brief The raw `io_uring_enter` syscall
+ */
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+/**
+ * @brief Creates an io_uring instance
+ *
+ * @param entries The submission queue size
+ * @return An opaque ring handle or `NULL` in case of an error
+ */
+void* uring_create(uint32_t entries) {
+    // Create the ring descriptor
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    // Allocate the ring state
+    struct uring* ring = calloc(1, sizeof(struct uring));
+    if (ring == NULL) {
+        close(fd);
+        return NULL;
+    }
+    ring->fd = fd;
+
+    // Map the submission queue ring, the submission entries and the completion queue ring
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+        IORING_OFF_SQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes =
+        mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+        IORING_OFF_CQ_RING);
+    if (ring->sq_ring == MAP_FAILED || ring->sqes == MAP_FAILED || ring->cq_ring == MAP_FAILED) {
+        close(fd);
+        free(ring);
+        return NULL;
+    }
+
+    // Resolve the queue pointers
+    ring->sq_head = (uint32_t*)(ring->sq_ring + params.sq_off.head);
+    ring->sq_tail = (uint32_t*)(ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = (uint32_t*)(ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_entries = (uint32_t*)(ring->sq_ring + params.sq_off.ring_entries);
+    ring->sq_array = (uint32_t*)(ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (uint32_t*)(ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (uint32_t*)(ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = (uint32_t*)(ring->cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(ring->cq_ring + params.cq_off.cqes);
+    return ring;
+}
+
+/**
+ * @brief Prepares the next free submission queue entry
+ *
+ * @param ring The ring handle
+ * @return The zeroed entry or `NULL` if the submission queue is full
+ */
+static struct io_uring_sqe* uring_next_sqe(struct uring* ring) {
+    // Bail out if the submission queue is full
+    uint32_t head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    uint32_t tail = *ring->sq_tail;
+    if (tail - head >= *ring->sq_entries) {
+        errno = EBUSY;
+        return NULL;
+    }
+
+    // Claim and publish the next entry
+    uint32_t index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->to_submit++;
+    return sqe;
+}
+
+/**
+ * @brief Queues a read of `fd` into `buf`
+ *
+ * @param ring The ring handle
+ * @param fd The file descriptor to read from
+ * @param buf The target buffer (must stay valid until the operation completes)
+ * @param len The target buffer size
+ * @param user_data The user data tag reported with the completion
+ * @return `0` or `-1` in case of an error
+ */
+int32_t uring_submit_read(void* ring_, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data) {
+    struct uring* ring = ring_;
+    struct io_uring_sqe* sqe = uring_next_sqe(ring);
+    if (sqe == NULL) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = user_data;
+    return 0;
+}
+
+/**
+ * @brief Queues a datagram receive from `fd` into `buf`
+ *
+ * @param ring The ring handle
+ * @param fd The socket file descriptor to receive from
+ * @param buf The target buffer (must stay valid until the operation completes)
+ * @param len The target buffer size
+ * @param user_data The user data tag reported with the completion
+ * @return `0` or `-1` in case of an error
+ */
+int32_t uring_submit_recv(void* ring_, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data) {
+    struct uring* ring = ring_;
+    struct io_uring_sqe* sqe = uring_next_sqe(ring);
+    if (sqe == NULL) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->user_data = user_data;
+    return 0;
+}
+
+/**
+ * @brief Submits all queued operations and waits for completions
+ *
+ * @param ring The ring handle
+ * @param completions The target array for the completions
+ * @param max The capacity of the target array
+ * @param timeout_ms The maximum time to wait in milliseconds (`-1` to wait forever)
+ * @return The amount of completions or `-1` in case of an error
+ */
+int32_t uring_wait(void* ring_, struct uring_completion* completions, uint32_t max, int32_t timeout_ms) {
+    struct uring* ring = ring_;
+
+    // Queue a self-completing timeout operation if a timeout is requested
+    if (timeout_ms >= 0) {
+        struct io_uring_sqe* sqe = uring_next_sqe(ring);
+        if (sqe == NULL) {
+            return -1;
+        }
+        ring->timeout.tv_sec = timeout_ms / 1000;
+        ring->timeout.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->addr = (uint64_t)(uintptr_t)&ring->timeout;
+        sqe->len = 1;
+        sqe->off = 1;
+        sqe->user_data = URING_TIMEOUT_DATA;
+    }
+
+    // Submit the queued operations and wait for at least one completion
+    int result = sys_io_uring_enter(ring->fd, ring->to_submit, 1, IORING_ENTER_GETEVENTS);
+    if (result < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    ring->to_submit = 0;
+
+    // Reap the completions, filtering out internal timeout operations
+    uint32_t count = 0;
+    uint32_t head = *ring->cq_head;
+    uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < max) {
+        struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+        if (cqe->user_data != URING_TIMEOUT_DATA) {
+            completions[count].user_data = cqe->user_data;
+            completions[count].result = (int64_t)cqe->res;
+            count++;
+        }
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return (int32_t)count;
+}
+
+/**
+ * @brief Destroys the ring and releases its resources
+ *
+ * @param ring The ring handle
+ */
+void uring_destroy(void* ring_) {
+    struct uring* ring = ring_;
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    munmap(ring->sqes, ring->sqes_size);
+    munmap(ring->cq_ring, ring->cq_ring_size);
+    close(ring->fd);
+    free(ring);
+}
+
+#else // !__linux__
+
+/// Stubs so the crate links on platforms without io_uring; the engine fails gracefully at startup
+void* uring_create(uint32_t entries) {
+    (void)entries;
+    errno = ENOSYS;
+    return 0;
+}
+int32_t uring_submit_read(void* ring, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data) {
+    (void)ring, (void)fd, (void)buf, (void)len, (void)user_data;
+    errno = ENOSYS;
+    return -1;
+}
+int32_t uring_submit_recv(void* ring, int32_t fd, uint8_t* buf, uint64_t len, uint64_t user_data) {
+    (void)ring, (void)fd, (void)buf, (void)len, (void)user_data;
+    errno = ENOSYS;
+    return -1;
+}
+int32_t uring_wait(void* ring, void* completions, uint32_t max, int32_t timeout_ms) {
+    (void)ring, (void)completions, (void)max, (void)timeout_ms;
+    errno = ENOSYS;
+    return -1;
+}
+void uring_destroy(void* ring) {
+    (void)ring;
+}
+
+#endif // __linux__